@@ -0,0 +1,142 @@
+//
+// Created by eu on 2026-10-19.
+//
+
+#ifndef GAME_ARENA_H
+#define GAME_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace Arena {
+    constexpr const size_t HUGE_PAGE_SIZE{2 * 1024 * 1024};
+
+    // 포인터만 앞으로 옮기며 할당하고 reset()으로 한 번에 비우는 할당기.
+    // 청크는 reset() 후에도 남겨 두므로 한 번 최대 크기까지 커지고 나면 더 이상 malloc을 호출하지 않는다.
+    class MonotonicArena {
+    private:
+        struct Chunk {
+            std::byte *data_;
+            size_t size_;
+        };
+
+        std::vector<Chunk> chunks_;
+        size_t chunk_index_{0};
+        size_t offset_{0};
+        size_t bytes_used_{0};
+        size_t peak_bytes_used_{0};
+
+        // 큰 페이지 경계에 맞춘 청크를 할당하고 가능하면 커널에 큰 페이지를 쓰도록 알린다.
+        void addChunk(const size_t min_size) {
+            const size_t last_size = this->chunks_.empty() ? 0 : this->chunks_.back().size_;
+            size_t size = std::max(min_size, last_size * 2);
+            size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            auto *data = static_cast<std::byte *>(std::aligned_alloc(HUGE_PAGE_SIZE, size));
+            if (data == nullptr) { throw std::bad_alloc(); }
+#ifdef __linux__
+            madvise(data, size, MADV_HUGEPAGE);
+#endif
+            this->chunks_.push_back(Chunk{data, size});
+        }
+
+    public:
+        explicit MonotonicArena(const size_t initial_size = HUGE_PAGE_SIZE) {
+            this->addChunk(initial_size);
+        }
+
+        MonotonicArena(const MonotonicArena &) = delete;
+        MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+        ~MonotonicArena() {
+            for (const auto &chunk: this->chunks_) {
+                std::free(chunk.data_);
+            }
+        }
+
+        void *allocate(const size_t bytes, const size_t alignment) {
+            while (true) {
+                const auto &chunk = this->chunks_[this->chunk_index_];
+                const size_t aligned = (this->offset_ + alignment - 1) / alignment * alignment;
+                if (aligned + bytes <= chunk.size_) {
+                    this->bytes_used_ += aligned - this->offset_ + bytes;
+                    this->peak_bytes_used_ = std::max(this->peak_bytes_used_, this->bytes_used_);
+                    this->offset_ = aligned + bytes;
+                    return chunk.data_ + aligned;
+                }
+                // 남은 청크 꼬리는 버리고 다음 청크로 넘어간다.
+                this->bytes_used_ += chunk.size_ - this->offset_;
+                this->offset_ = 0;
+                if (++this->chunk_index_ == this->chunks_.size()) {
+                    this->addChunk(bytes + alignment);
+                }
+            }
+        }
+
+        // 할당한 것을 모두 버린다. 청크는 다음 사용을 위해 남겨 둔다.
+        void reset() {
+            this->chunk_index_ = 0;
+            this->offset_ = 0;
+            this->bytes_used_ = 0;
+        }
+
+        // 마지막 reset() 이후 할당한 바이트 수 (정렬과 청크 꼬리로 버린 바이트 포함)
+        size_t bytesUsed() const {
+            return this->bytes_used_;
+        }
+
+        // 지금까지 bytesUsed()의 최댓값. 처음 크기를 정하는 데 쓴다.
+        size_t peakBytesUsed() const {
+            return this->peak_bytes_used_;
+        }
+
+        // 확보해 둔 청크 크기의 합
+        size_t bytesReserved() const {
+            size_t bytes = 0;
+            for (const auto &chunk: this->chunks_) {
+                bytes += chunk.size_;
+            }
+            return bytes;
+        }
+    };
+
+    // 표준 컨테이너가 MonotonicArena에서 메모리를 받도록 하는 할당기. 해제는 reset() 때 한 번에 한다.
+    template<typename T>
+    class ArenaAllocator {
+    private:
+        MonotonicArena *arena_;
+
+        template<typename U>
+        friend class ArenaAllocator;
+
+    public:
+        using value_type = T;
+
+        explicit ArenaAllocator(MonotonicArena &arena): arena_(&arena) {
+        }
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U> &other): arena_(other.arena_) {
+        }
+
+        T *allocate(const size_t n) {
+            return static_cast<T *>(this->arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *, size_t) {
+        }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U> &other) const {
+            return this->arena_ == other.arena_;
+        }
+    };
+}
+
+#endif //GAME_ARENA_H
@@ -0,0 +1,90 @@
+//
+// Created by eu on 2026-10-19.
+//
+
+#ifndef GAME_ASYNCSEARCH_H
+#define GAME_ASYNCSEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace AsyncSearch {
+    // 행동을 고르는 탐색의 중간 결과
+    struct ActionScore {
+        int action_{-1};
+        int64_t score_{0};
+    };
+
+    // 탐색을 백그라운드 스레드에서 실행한다.
+    // 탐색 함수는 stop_token을 주기적으로 확인하고, 더 나은 결과를 찾을 때마다 publish()로 알린다.
+    template<typename Best>
+    class SearchTask {
+    private:
+        mutable std::mutex mutex_;
+        std::optional<Best> best_;
+        std::atomic<bool> is_running_{false};
+        std::jthread thread_;
+
+    public:
+        SearchTask() = default;
+        SearchTask(const SearchTask &) = delete;
+        SearchTask &operator=(const SearchTask &) = delete;
+
+        ~SearchTask() {
+            this->cancel();
+        }
+
+        // search(stop_token, task)를 새 스레드에서 실행한다. 이전 탐색이 남아 있으면 취소하고 기다린다.
+        template<typename Search>
+        void start(Search search) {
+            this->cancel();
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                this->best_.reset();
+            }
+            this->is_running_ = true;
+            this->thread_ = std::jthread([this, search = std::move(search)](std::stop_token stop_token) mutable {
+                search(stop_token, *this);
+                this->is_running_ = false;
+            });
+        }
+
+        void publish(const Best &best) {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->best_ = best;
+        }
+
+        // 지금까지 찾은 최선. 아직 없으면 std::nullopt
+        std::optional<Best> poll() const {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            return this->best_;
+        }
+
+        bool isRunning() const {
+            return this->is_running_;
+        }
+
+        // 탐색에 중단을 요청하고 스레드가 끝날 때까지 기다린다.
+        void cancel() {
+            if (this->thread_.joinable()) {
+                this->thread_.request_stop();
+                this->thread_.join();
+            }
+        }
+
+        // 탐색이 스스로 끝날 때까지 기다린 뒤 최선을 반환한다.
+        std::optional<Best> wait() {
+            if (this->thread_.joinable()) {
+                this->thread_.join();
+            }
+            return this->poll();
+        }
+    };
+}
+
+#endif //GAME_ASYNCSEARCH_H
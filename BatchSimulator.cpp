@@ -0,0 +1,318 @@
+//
+// Created by eu on 2026-10-19.
+//
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <iostream>
+#include <vector>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include "BoardGenerator.h"
+
+namespace BatchSimulator {
+    using ScoreType = int64_t;
+    constexpr const ScoreType INF = 1000000000LL;
+
+    struct Coord {
+        int y_;
+        int x_;
+
+        Coord(const int y = 0, const int x = 0): y_(y), x_(x) {
+        }
+    };
+
+    // 미로 게임 (BeamSearchWithTime과 같은 설정)
+    constexpr const int H{30};
+    constexpr const int W{30};
+    constexpr int END_TURN{100};
+
+    class TimeKeeper {
+    private:
+        std::chrono::time_point<std::chrono::high_resolution_clock> start_time_;
+
+    public:
+        TimeKeeper(): start_time_(std::chrono::high_resolution_clock::now()) {
+        }
+
+        double elapsedSeconds() const {
+            std::chrono::duration<double> diff = std::chrono::high_resolution_clock::now() - this->start_time_;
+            return diff.count();
+        }
+    };
+
+    class State {
+    private:
+        int points_[H][W] = {};
+        int turn_{0};
+
+        static constexpr const int dx[4] = {1, -1, 0, 0};
+        static constexpr const int dy[4] = {0, 0, 1, -1};
+
+    public:
+        Coord character_ = Coord(0, 0);
+        int game_score_ = 0;
+
+        State() = default;
+
+        State(const int seed) {
+            auto mt_for_construct = std::mt19937(seed);
+            this->character_.y_ = mt_for_construct() % H;
+            this->character_.x_ = mt_for_construct() % W;
+
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    if (y == character_.y_ && x == character_.x_) {
+                        continue;
+                    }
+                    this->points_[y][x] = mt_for_construct() % 10;
+                }
+            }
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        int turn() const {
+            return this->turn_;
+        }
+
+        int point(const int y, const int x) const {
+            return this->points_[y][x];
+        }
+
+        void advance(const int action) {
+            this->character_.x_ += dx[action];
+            this->character_.y_ += dy[action];
+            auto &point = this->points_[this->character_.y_][this->character_.x_];
+            if (point > 0) {
+                this->game_score_ += point;
+                point = 0;
+            }
+            this->turn_++;
+        }
+
+        // 현재 상황에서 플레이어가 가능한 행동을 모두 획득한다.
+        std::vector<int> legalActions() const {
+            std::vector<int> actions;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions.emplace_back(action);
+                }
+            }
+            return actions;
+        }
+    };
+
+    // 가능한 행동 비트마스크별 행동 개수와 k번째 행동
+    struct ActionTable {
+        uint8_t count_[16];
+        uint8_t action_[16][4];
+
+        constexpr ActionTable(): count_(), action_() {
+            for (int mask = 0; mask < 16; mask++) {
+                int count = 0;
+                for (int action = 0; action < 4; action++) {
+                    if (mask >> action & 1) {
+                        this->action_[mask][count++] = static_cast<uint8_t>(action);
+                    }
+                }
+                this->count_[mask] = static_cast<uint8_t>(count);
+            }
+        }
+    };
+
+    constexpr const ActionTable ACTION_TABLE{};
+
+    // N개의 미로 게임을 배열별로 나눠 저장하고 모든 게임을 같은 턴씩 진행한다.
+    class MazeBatch {
+    private:
+        static constexpr const int CELL_N{H * W};
+        static constexpr const int32_t delta[4] = {1, -1, W, -W};
+
+        int size_;
+        int turn_{0};
+        // 게임 i의 칸 c는 points_[i * CELL_N + c]
+        std::vector<uint8_t> points_;
+        std::vector<int32_t> positions_;
+        std::vector<int32_t> scores_;
+        std::vector<uint64_t> rngs_;
+        std::vector<uint8_t> actions_;
+
+    public:
+        explicit MazeBatch(const int size, const uint64_t seed = 0)
+            : size_(size), points_((size_t) size * CELL_N), positions_(size), scores_(size), rngs_(size),
+              actions_(size) {
+            for (int i = 0; i < size; i++) {
+                this->rngs_[i] = (seed + i + 1) * 0x9E3779B97F4A7C15ULL;
+            }
+        }
+
+        int size() const {
+            return this->size_;
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        int score(const int i) const {
+            return this->scores_[i];
+        }
+
+        // 게임 i에 state를 복사한다. 모든 게임은 같은 턴에서 시작해야 한다.
+        void load(const int i, const State &state) {
+            uint8_t *points = &this->points_[(size_t) i * CELL_N];
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    points[y * W + x] = static_cast<uint8_t>(state.point(y, x));
+                }
+            }
+            this->positions_[i] = state.character_.y_ * W + state.character_.x_;
+            this->scores_[i] = state.game_score_;
+            this->turn_ = state.turn();
+        }
+
+        // State를 거치지 않고 first_index번째부터의 게임판을 배열에 바로 병렬로 만든다. 모든 게임은 0턴에서 시작한다.
+        void generate(const uint64_t seed, const uint64_t first_index = 0) {
+            BoardGenerator::generateBoards(seed, first_index, this->size_, H, W, this->points_.data(),
+                                           this->positions_.data());
+            std::fill(this->scores_.begin(), this->scores_.end(), 0);
+            this->turn_ = 0;
+        }
+
+        // 모든 게임에서 무작위 행동을 한 턴 진행한다.
+        void advanceRandom() {
+            this->advanceRandom(0, this->size_);
+            this->turn_++;
+        }
+
+        // 게임판이 캐시에 남아 있도록 BLOCK_SIZE개씩 끝까지 진행한다.
+        void playoutRandom() {
+            for (int begin = 0; begin < this->size_; begin += BLOCK_SIZE) {
+                const int end = std::min(this->size_, begin + BLOCK_SIZE);
+                for (int turn = this->turn_; turn < END_TURN; turn++) {
+                    this->advanceRandom(begin, end);
+                }
+            }
+            this->turn_ = END_TURN;
+        }
+
+    private:
+        static constexpr const int BLOCK_SIZE{64};
+
+        void advanceRandom(const int begin, const int end) {
+            uint64_t *rngs = this->rngs_.data();
+            int32_t *positions = this->positions_.data();
+            uint8_t *actions = this->actions_.data();
+
+            for (int i = begin; i < end; i++) {
+                uint64_t x = rngs[i];
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                rngs[i] = x;
+            }
+            for (int i = begin; i < end; i++) {
+                const int32_t position = positions[i];
+                const int32_t y = position / W;
+                const int32_t x = position - y * W;
+                const int mask = (x < W - 1) | ((x > 0) << 1) | ((y < H - 1) << 2) | ((y > 0) << 3);
+                const uint32_t r = static_cast<uint32_t>(rngs[i] >> 32);
+                const uint32_t k = static_cast<uint32_t>(((uint64_t) r * ACTION_TABLE.count_[mask]) >> 32);
+                actions[i] = ACTION_TABLE.action_[mask][k];
+            }
+            this->applyActions(begin, end);
+        }
+
+        // actions_에 들어 있는 행동을 적용하고 점수를 모은다.
+        void applyActions(const int begin, const int end) {
+            int32_t *positions = this->positions_.data();
+            int32_t *scores = this->scores_.data();
+            uint8_t *points = this->points_.data();
+            const uint8_t *actions = this->actions_.data();
+
+            for (int i = begin; i < end; i++) {
+                positions[i] += delta[actions[i]];
+            }
+            for (int i = begin; i < end; i++) {
+                uint8_t &point = points[(size_t) i * CELL_N + positions[i]];
+                scores[i] += point;
+                point = 0;
+            }
+        }
+    };
+
+    std::mt19937 mt_for_action(0);
+
+    int randomAction(const State &state) {
+        auto legal_actions = state.legalActions();
+        return legal_actions[mt_for_action() % legal_actions.size()];
+    }
+
+    // 무작위 플레이아웃의 처리량을 기존의 State 단위 반복과 비교한다.
+    void testRandomPlayout(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        std::vector<State> states;
+        for (int i = 0; i < game_number; i++) {
+            states.emplace_back(State(mt_for_construct()));
+        }
+
+        double scalar_score_mean{0};
+        TimeKeeper scalar_time_keeper;
+        for (const auto &initial_state: states) {
+            auto state = initial_state;
+            while (!state.isDone()) {
+                state.advance(randomAction(state));
+            }
+            scalar_score_mean += state.game_score_;
+        }
+        const double scalar_seconds = scalar_time_keeper.elapsedSeconds();
+
+        double batch_score_mean{0};
+        TimeKeeper batch_time_keeper;
+        MazeBatch batch(game_number);
+        for (int i = 0; i < game_number; i++) {
+            batch.load(i, states[i]);
+        }
+        batch.playoutRandom();
+        for (int i = 0; i < game_number; i++) {
+            batch_score_mean += batch.score(i);
+        }
+        const double batch_seconds = batch_time_keeper.elapsedSeconds();
+
+        std::cout << "Scalar score:\t" << scalar_score_mean / game_number << "\n";
+        std::cout << "Scalar games/sec:\t" << game_number / scalar_seconds << "\n";
+        std::cout << "Batch score:\t" << batch_score_mean / game_number << "\n";
+        std::cout << "Batch games/sec:\t" << game_number / batch_seconds << "\n";
+    }
+
+    // 게임판을 배열에 바로 만들어 무작위 플레이아웃한다. State(seed)를 만들고 load()하는 경우와 비교한다.
+    void testGeneratedPlayout(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        TimeKeeper load_time_keeper;
+        MazeBatch load_batch(game_number);
+        for (int i = 0; i < game_number; i++) {
+            load_batch.load(i, State(mt_for_construct()));
+        }
+        const double load_seconds = load_time_keeper.elapsedSeconds();
+
+        TimeKeeper generate_time_keeper;
+        MazeBatch batch(game_number);
+        batch.generate(0);
+        const double generate_seconds = generate_time_keeper.elapsedSeconds();
+
+        batch.playoutRandom();
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            score_mean += batch.score(i);
+        }
+        std::cout << "Load boards/sec:\t" << game_number / load_seconds << "\n";
+        std::cout << "Generate boards/sec:\t" << game_number / generate_seconds << "\n";
+        std::cout << "Score:\t" << score_mean / game_number << "\n";
+    }
+}
@@ -7,6 +7,7 @@
 #include <vector>
 #include <sstream>
 #include <queue>
+#include <algorithm>
 
 namespace BeamSearch {
     using ScoreType = int64_t;
@@ -35,6 +36,8 @@ namespace BeamSearch {
     public:
         // 탐색 트리의 루트 노드에서 처음으로 선택한 행동
         int first_action_{-1};
+        // 탐색 중에 기록한 SearchNode 번호 (-1이면 루트)
+        int node_id_{-1};
 
         bool operator<(const State &maze_1, const State &maze_2) const {
             return maze_1.evaluated_score_ < maze_2.evaluated_score_;
@@ -182,6 +185,129 @@ namespace BeamSearch {
         return best_state.first_action_;
     }
 
+    // 탐색 트리의 노드. 행동열은 상태를 복사하지 않고 부모를 따라가며 복원한다.
+    struct SearchNode {
+        int parent_;
+        int action_;
+    };
+
+    // 탐색으로 찾은 행동열과 그 끝에서의 점수
+    struct Plan {
+        std::vector<int> actions_;
+        ScoreType score_{-INF};
+    };
+
+    Plan beamSearchPlan(const State &state, const int beam_width, const int beam_depth) {
+        std::vector<SearchNode> nodes;
+        std::priority_queue<State> now_beam;
+        State best_state = state;
+
+        now_beam.push(state);
+        for (int t = 0; t < beam_depth; t++) {
+            std::priority_queue<State> next_beam;
+            for (int i = 0; i < beam_width; ++i) {
+                if (now_beam.empty()) { break; }
+                State now_state = now_beam.top();
+                now_beam.pop();
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    nodes.push_back(SearchNode{now_state.node_id_, action});
+                    next_state.node_id_ = (int) nodes.size() - 1;
+                    next_beam.push(next_state);
+                }
+            }
+            if (next_beam.empty()) { break; }
+
+            now_beam = next_beam;
+            best_state = now_beam.top();
+
+            if (best_state.isDone()) { break; }
+        }
+
+        Plan plan;
+        plan.score_ = best_state.game_score_;
+        for (int id = best_state.node_id_; id != -1; id = nodes[id].parent_) {
+            plan.actions_.emplace_back(nodes[id].action_);
+        }
+        std::reverse(plan.actions_.begin(), plan.actions_.end());
+        return plan;
+    }
+
+    // 한 번 계산한 행동열을 그대로 재생한다. 상태가 예상과 어긋나면 무효가 된다.
+    class PlanCache {
+    private:
+        Plan plan_;
+        // i번째 행동을 실행하기 직전에 예상되는 캐릭터 위치와 점수
+        std::vector<Coord> expected_characters_;
+        std::vector<int> expected_scores_;
+        size_t cursor_{0};
+
+    public:
+        void reset(const State &state, Plan plan) {
+            this->plan_ = std::move(plan);
+            this->cursor_ = 0;
+            this->expected_characters_.clear();
+            this->expected_scores_.clear();
+            State now_state = state;
+            for (const auto action: this->plan_.actions_) {
+                this->expected_characters_.emplace_back(now_state.character_);
+                this->expected_scores_.emplace_back(now_state.game_score_);
+                now_state.advance(action);
+            }
+        }
+
+        bool isValid(const State &state) const {
+            if (this->cursor_ >= this->plan_.actions_.size()) { return false; }
+            const auto &character = this->expected_characters_[this->cursor_];
+            return state.character_.y_ == character.y_ && state.character_.x_ == character.x_ &&
+                   state.game_score_ == this->expected_scores_[this->cursor_];
+        }
+
+        // 계획대로 진행했을 때의 최종 점수
+        ScoreType expectedScore() const {
+            return this->plan_.score_;
+        }
+
+        int nextAction() {
+            return this->plan_.actions_[this->cursor_++];
+        }
+    };
+
+    // 처음에 한 번 탐색한 뒤로는 캐시한 행동열을 재생한다.
+    // replan_number가 남아 있으면 더 넓은 빔으로 다시 탐색해서 점수가 오를 때만 계획을 바꾼다.
+    int planCachedAction(const State &state, PlanCache &cache, const int beam_width, int &replan_number) {
+        if (!cache.isValid(state)) {
+            cache.reset(state, beamSearchPlan(state, beam_width, END_TURN));
+        } else if (replan_number > 0) {
+            replan_number--;
+            auto plan = beamSearchPlan(state, beam_width * 2, END_TURN);
+            if (plan.score_ > cache.expectedScore()) {
+                cache.reset(state, std::move(plan));
+            }
+        }
+        return cache.nextAction();
+    }
+
+    void testAiScoreWithPlanCache(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            PlanCache cache;
+            int replan_number{1};
+            while (!state.isDone()) {
+                state.advance(planCachedAction(state, cache, 2, replan_number));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+
     void testAiScore(const int game_number) {
         std::mt19937 mt_for_construct(0);
         double score_mean{0};
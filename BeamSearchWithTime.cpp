@@ -8,6 +8,18 @@
 #include <sstream>
 #include <queue>
 #include <chrono>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <cstdio>
+#include <charconv>
+#include <memory>
+#include "Arena.h"
+#include "AsyncSearch.h"
+#include "SessionScheduler.h"
 
 namespace BeamSearchWithTime {
     using ScoreType = int64_t;
@@ -42,6 +54,21 @@ namespace BeamSearchWithTime {
             auto diff = std::chrono::high_resolution_clock::now() - this->start_time_;
             return duration_cast<milliseconds>(diff).count() >= time_threshold_;
         }
+
+        // 경과 시간을 밀리초 단위의 실수로 반환
+        double elapsedMilliseconds() const {
+            std::chrono::duration<double, std::milli> diff = std::chrono::high_resolution_clock::now() - this->start_time_;
+            return diff.count();
+        }
+
+        int64_t timeThreshold() const {
+            return this->time_threshold_;
+        }
+
+        // 시간 제한을 늘린다.
+        void extend(const int64_t time_threshold) {
+            this->time_threshold_ += time_threshold;
+        }
     };
 
     class State {
@@ -55,6 +82,8 @@ namespace BeamSearchWithTime {
     public:
         // 탐색 트리의 루트 노드에서 처음으로 선택한 행동
         int first_action_{-1};
+        // SearchTree 안에서의 노드 번호 (-1이면 루트)
+        int node_id_{-1};
 
         bool operator<(const State &maze_1, const State &maze_2) const {
             return maze_1.evaluated_score_ < maze_2.evaluated_score_;
@@ -85,6 +114,14 @@ namespace BeamSearchWithTime {
             return this->turn_ == END_TURN;
         }
 
+        int turn() const {
+            return this->turn_;
+        }
+
+        int point(const int y, const int x) const {
+            return this->points_[y][x];
+        }
+
         void advance(const int action) {
             this->character_.x_ += dx[action];
             this->character_.y_ += dy[action];
@@ -109,6 +146,19 @@ namespace BeamSearchWithTime {
             return actions;
         }
 
+        // legalActions()와 같지만 힙 할당 없이 actions에 채우고 개수를 반환한다.
+        int legalActions(int (&actions)[4]) const {
+            int action_n = 0;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions[action_n++] = action;
+                }
+            }
+            return action_n;
+        }
+
         // 현재 게임 상황을 문자열로 만든다.
         std::string toString() const {
             std::stringstream ss;
@@ -139,6 +189,74 @@ namespace BeamSearchWithTime {
         }
     };
 
+    // 탐색 트리의 노드. 부모 번호와 부모에서 선택한 행동만 기록한다.
+    struct SearchNode {
+        int parent_;
+        int action_;
+    };
+
+    // 이전 턴에서 탐색한 빔을 다음 턴에 이어서 사용하기 위해 보관한다.
+    class SearchTree {
+    public:
+        std::vector<SearchNode> nodes_;
+        // 마지막으로 끝까지 전개한 층
+        std::vector<State> frontier_;
+
+        void clear() {
+            this->nodes_.clear();
+            this->frontier_.clear();
+        }
+
+        int addNode(const int parent, const int action) {
+            this->nodes_.push_back(SearchNode{parent, action});
+            return (int) this->nodes_.size() - 1;
+        }
+
+        // 실제로 선택한 행동 아래의 서브트리를 새 루트로 올리고 나머지는 버린다.
+        void promote(const int action) {
+            const int n = (int) this->nodes_.size();
+            // frontier에서 거슬러 올라가며 살아있는 노드를 표시한다.
+            std::vector<char> alive(n, 0);
+            for (const auto &state: this->frontier_) {
+                for (int id = state.node_id_; id != -1 && !alive[id]; id = this->nodes_[id].parent_) {
+                    alive[id] = 1;
+                }
+            }
+            // 부모는 항상 자식보다 먼저 추가되므로 한 번의 순회로 번호를 다시 매길 수 있다.
+            constexpr const int DROPPED{-2};
+            std::vector<int> remap(n, DROPPED);
+            std::vector<SearchNode> next_nodes;
+            std::vector<int> first_actions;
+            for (int id = 0; id < n; id++) {
+                if (!alive[id]) { continue; }
+                const auto &node = this->nodes_[id];
+                if (node.parent_ == -1) {
+                    if (node.action_ == action) { remap[id] = -1; }
+                    continue;
+                }
+                const int parent = remap[node.parent_];
+                if (parent == DROPPED) { continue; }
+                remap[id] = (int) next_nodes.size();
+                next_nodes.push_back(SearchNode{parent, node.action_});
+                first_actions.push_back(parent == -1 ? node.action_ : first_actions[parent]);
+            }
+
+            std::vector<State> next_frontier;
+            for (auto &state: this->frontier_) {
+                // 첫 층을 전개하기 전에 시간이 다 되면 루트(-1)가 남아 있을 수 있다. 루트는 이미 지나간 상태이므로 버린다.
+                if (state.node_id_ < 0) { continue; }
+                const int id = remap[state.node_id_];
+                if (id < 0) { continue; }
+                state.node_id_ = id;
+                state.first_action_ = first_actions[id];
+                next_frontier.emplace_back(state);
+            }
+            this->nodes_.swap(next_nodes);
+            this->frontier_.swap(next_frontier);
+            if (this->frontier_.empty()) { this->nodes_.clear(); }
+        }
+    };
+
     std::mt19937 mt_for_action(0);
 
     int randomAction(const State &state) {
@@ -172,6 +290,137 @@ namespace BeamSearchWithTime {
         }
     }
 
+    // 게임판을 미리 잡아 둔 버퍼에 문자로 바로 써 넣는다. 버퍼는 재사용하며 차면 한 번에 out으로 내보낸다.
+    class BoardRenderer {
+    private:
+        static constexpr const size_t BUFFER_SIZE{1 << 16};
+        // 한 턴을 그리는 데 필요한 최대 크기. 모든 칸이 바뀐 diff("yy xx c\n" 8바이트씩)가 가장 크다.
+        static constexpr const size_t FRAME_SIZE{H * W * 8 + 64};
+        static_assert(FRAME_SIZE <= BUFFER_SIZE);
+
+        std::FILE *out_;
+        std::unique_ptr<char[]> buffer_{new char[BUFFER_SIZE]};
+        size_t size_{0};
+        // 마지막으로 그린 게임판의 칸 문자 (캐릭터 제외)
+        char previous_[H][W] = {};
+        bool has_previous_{false};
+
+        void reserveFrame() {
+            if (this->size_ + FRAME_SIZE > BUFFER_SIZE) {
+                this->flush();
+            }
+        }
+
+        // 문자열 리터럴을 끝의 '\0' 없이 붙인다.
+        template<size_t N>
+        void append(const char (&text)[N]) {
+            std::memcpy(this->buffer_.get() + this->size_, text, N - 1);
+            this->size_ += N - 1;
+        }
+
+        void append(const char c) {
+            this->buffer_[this->size_++] = c;
+        }
+
+        void append(const int64_t value) {
+            char *begin = this->buffer_.get();
+            auto result = std::to_chars(begin + this->size_, begin + BUFFER_SIZE, value);
+            this->size_ = result.ptr - begin;
+        }
+
+        void appendHeader(const State &state) {
+            this->append("turn:\t");
+            this->append((int64_t) state.turn());
+            this->append("\nscore:\t");
+            this->append((int64_t) state.game_score_);
+            this->append('\n');
+        }
+
+        static char cellChar(const State &state, const int y, const int x) {
+            const int point = state.point(y, x);
+            return point > 0 ? (char) ('0' + point) : '.';
+        }
+
+    public:
+        explicit BoardRenderer(std::FILE *out = stdout): out_(out) {
+        }
+
+        BoardRenderer(const BoardRenderer &) = delete;
+        BoardRenderer &operator=(const BoardRenderer &) = delete;
+
+        ~BoardRenderer() {
+            this->flush();
+        }
+
+        // toString()과 같은 형식으로 게임판 전체를 그린다.
+        void render(const State &state) {
+            this->reserveFrame();
+            this->appendHeader(state);
+            for (int h = 0; h < H; h++) {
+                for (int w = 0; w < W; w++) {
+                    const char c = cellChar(state, h, w);
+                    this->previous_[h][w] = c;
+                    this->append(state.character_.y_ == h && state.character_.x_ == w ? '@' : c);
+                }
+                this->append('\n');
+            }
+            this->append('\n');
+            this->has_previous_ = true;
+        }
+
+        // 마지막으로 그린 게임판과 달라진 칸만 "y x 문자" 줄로, 캐릭터 위치는 "@ y x" 줄로 그린다.
+        // 처음 호출하면 게임판 전체를 그린다.
+        void renderDiff(const State &state) {
+            if (!this->has_previous_) {
+                this->render(state);
+                return;
+            }
+            this->reserveFrame();
+            this->appendHeader(state);
+            this->append("@ ");
+            this->append((int64_t) state.character_.y_);
+            this->append(' ');
+            this->append((int64_t) state.character_.x_);
+            this->append('\n');
+            for (int h = 0; h < H; h++) {
+                for (int w = 0; w < W; w++) {
+                    const char c = cellChar(state, h, w);
+                    if (c == this->previous_[h][w]) { continue; }
+                    this->previous_[h][w] = c;
+                    this->append((int64_t) h);
+                    this->append(' ');
+                    this->append((int64_t) w);
+                    this->append(' ');
+                    this->append(c);
+                    this->append('\n');
+                }
+            }
+            this->append('\n');
+        }
+
+        void flush() {
+            if (this->size_ > 0) {
+                std::fwrite(this->buffer_.get(), 1, this->size_, this->out_);
+                this->size_ = 0;
+            }
+        }
+    };
+
+    // playGame과 같지만 BoardRenderer로 출력한다. is_diff가 true이면 첫 턴 뒤로는 달라진 칸만 출력한다.
+    void playGameTrace(const int seed, const bool is_diff) {
+        auto state = State(seed);
+        BoardRenderer renderer;
+        renderer.render(state);
+        while (!state.isDone()) {
+            state.advance(greedyAction(state));
+            if (is_diff) {
+                renderer.renderDiff(state);
+            } else {
+                renderer.render(state);
+            }
+        }
+    }
+
     int beamSearchAction(const State &state, const int beam_width, const int beam_depth) {
         std::priority_queue<State> now_beam;
         State best_state;
@@ -238,6 +487,85 @@ namespace BeamSearchWithTime {
         return best_state.first_action_;
     }
 
+    // 점수별 개수를 세는 방식을 쓸 수 있는 최대 점수 범위. 이보다 넓으면 nth_element를 사용한다.
+    constexpr const ScoreType MAX_BUCKET_RANGE{1 << 16};
+
+    // states 중 evaluated_score_가 높은 beam_width개를 앞쪽으로 모으고 나머지는 버린다.
+    // 점수가 좁은 범위의 정수이므로 비교 정렬 없이 점수별 개수로 경계 점수를 구한 뒤 한 번에 골라낸다.
+    void selectTopStates(std::vector<State> &states, const int beam_width, std::vector<int> &counts) {
+        if ((int) states.size() <= beam_width) { return; }
+
+        ScoreType min_score = INF;
+        ScoreType max_score = -INF;
+        for (const auto &state: states) {
+            min_score = std::min(min_score, state.evaluated_score_);
+            max_score = std::max(max_score, state.evaluated_score_);
+        }
+        if (max_score - min_score >= MAX_BUCKET_RANGE) {
+            std::nth_element(states.begin(), states.begin() + beam_width, states.end(),
+                             [](const State &a, const State &b) { return a.evaluated_score_ > b.evaluated_score_; });
+            states.resize(beam_width);
+            return;
+        }
+
+        counts.assign(max_score - min_score + 1, 0);
+        for (const auto &state: states) {
+            counts[state.evaluated_score_ - min_score]++;
+        }
+        // 높은 점수부터 더해서 beam_width개에 도달하는 경계 점수를 찾는다.
+        int rest = beam_width;
+        ScoreType threshold = max_score;
+        for (;; threshold--) {
+            const int count = counts[threshold - min_score];
+            if (count >= rest) { break; }
+            rest -= count;
+        }
+        // 경계 점수보다 높은 상태는 모두, 경계 점수와 같은 상태는 rest개만 남긴다.
+        int size = 0;
+        for (int i = 0; i < (int) states.size(); i++) {
+            const auto score = states[i].evaluated_score_;
+            if (score > threshold || (score == threshold && rest-- > 0)) {
+                if (size != i) { states[size] = std::move(states[i]); }
+                size++;
+            }
+        }
+        states.resize(size);
+    }
+
+    int beamSearchActionByBucket(const State &state, const int beam_width, const int beam_depth) {
+        std::vector<State> now_beam;
+        std::vector<State> next_beam;
+        std::vector<int> counts;
+
+        now_beam.emplace_back(state);
+        for (int t = 0; t < beam_depth; t++) {
+            next_beam.clear();
+            for (const State &now_state: now_beam) {
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.emplace_back(next_state);
+                }
+            }
+            selectTopStates(next_beam, beam_width, counts);
+
+            now_beam.swap(next_beam);
+            if (now_beam.front().isDone()) { break; }
+        }
+
+        const State *best_state = &now_beam.front();
+        for (const State &now_state: now_beam) {
+            if (now_state.evaluated_score_ > best_state->evaluated_score_) {
+                best_state = &now_state;
+            }
+        }
+        return best_state->first_action_;
+    }
+
     int beamSearchActionWithTimeThreshold(const State &state, const int beam_width, const int64_t time_threshold) {
         auto time_keeper = TimeKeeper(time_threshold);
 
@@ -248,10 +576,11 @@ namespace BeamSearchWithTime {
         for (int t = 0; ; t++) {
             std::priority_queue<State> next_beam;
             for (int i = 0; i < beam_width; ++i) {
-                if (time_keeper.isTimeOver()) {
+                // 첫 층은 행동을 고르기 위해 항상 끝낸다.
+                if (t > 0 && time_keeper.isTimeOver()) {
                     return best_state.first_action_;
                 }
-
+                if (now_beam.empty()) { break; }
 
                 State now_state = now_beam.top();
                 now_beam.pop();
@@ -275,6 +604,748 @@ namespace BeamSearchWithTime {
         return best_state.first_action_;
     }
 
+    // 아레나에서 메모리를 받는 빔. 미리 capacity만큼 잡아 두므로 탐색 중에 다시 할당하지 않는다.
+    using ArenaBeam = std::priority_queue<State, std::vector<State, Arena::ArenaAllocator<State> > >;
+
+    ArenaBeam makeArenaBeam(Arena::MonotonicArena &arena, const size_t capacity) {
+        std::vector<State, Arena::ArenaAllocator<State> > container{Arena::ArenaAllocator<State>(arena)};
+        container.reserve(capacity);
+        return ArenaBeam(std::less<State>(), std::move(container));
+    }
+
+    // beamSearchActionWithTimeThreshold와 같지만 깊이별 빔을 arena에서 할당한다. 호출할 때마다 arena를 비우고 다시 쓴다.
+    int beamSearchActionWithTimeThreshold(const State &state, const int beam_width, const int64_t time_threshold,
+                                          Arena::MonotonicArena &arena) {
+        auto time_keeper = TimeKeeper(time_threshold);
+        arena.reset();
+
+        auto now_beam = makeArenaBeam(arena, 1);
+        State best_state;
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            auto next_beam = makeArenaBeam(arena, (size_t) beam_width * 4);
+            for (int i = 0; i < beam_width; ++i) {
+                // 첫 층은 행동을 고르기 위해 항상 끝낸다.
+                if (t > 0 && time_keeper.isTimeOver()) {
+                    return best_state.first_action_;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                int legal_actions[4];
+                const int legal_action_n = now_state.legalActions(legal_actions);
+                for (int a = 0; a < legal_action_n; a++) {
+                    const int action = legal_actions[a];
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = std::move(next_beam);
+            best_state = now_beam.top();
+
+            if (best_state.isDone()) { break; }
+        }
+        return best_state.first_action_;
+    }
+
+    void testAiScoreWithArena(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        Arena::MonotonicArena arena;
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                state.advance(beamSearchActionWithTimeThreshold(state, 5, 10, arena));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+        std::cout << "Arena:\t" << arena.peakBytesUsed() << " / " << arena.bytesReserved() << " bytes\n";
+    }
+
+    // tree에 남아있는 이전 턴의 빔부터 탐색을 이어간다. 호출한 쪽은 행동을 실행한 뒤 tree.promote()를 호출한다.
+    int beamSearchActionWithTimeThreshold(const State &state, const int beam_width, const int64_t time_threshold,
+                                          SearchTree &tree) {
+        auto time_keeper = TimeKeeper(time_threshold);
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+
+        if (tree.frontier_.empty()) {
+            tree.clear();
+            now_beam.push(state);
+        } else {
+            for (const auto &retained_state: tree.frontier_) {
+                now_beam.push(retained_state);
+            }
+            tree.frontier_.clear();
+            best_state = now_beam.top();
+        }
+
+        // 시간 제한으로 층 중간에 멈추면 이번 층에서 이미 꺼낸 노드도 frontier로 되돌린다.
+        std::vector<State> popped_states;
+        bool is_time_over = false;
+        while (!best_state.isDone()) {
+            std::priority_queue<State> next_beam;
+            popped_states.clear();
+            for (int i = 0; i < beam_width; ++i) {
+                // 새 트리의 첫 층은 행동을 고르기 위해 항상 끝낸다.
+                if (best_state.first_action_ != -1 && time_keeper.isTimeOver()) {
+                    is_time_over = true;
+                    break;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                popped_states.emplace_back(now_state);
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    next_state.node_id_ = tree.addNode(now_state.node_id_, action);
+                    if (now_state.node_id_ == -1)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+            if (is_time_over) { break; }
+
+            now_beam = next_beam;
+            best_state = now_beam.top();
+        }
+
+        tree.frontier_ = std::move(popped_states);
+        if (!is_time_over) { tree.frontier_.clear(); }
+        while (!now_beam.empty()) {
+            tree.frontier_.emplace_back(now_beam.top());
+            now_beam.pop();
+        }
+        return best_state.first_action_;
+    }
+
+    // 최선의 첫 행동이 이 층 수만큼 바뀌지 않았으면 결정이 안정되었다고 본다.
+    constexpr const int STABLE_LAYER_N{3};
+
+    // 호출한 쪽이 준 time_keeper의 시간 안에서 탐색한다.
+    // 시간이 다 되었을 때 최선의 첫 행동이 최근에 바뀌었다면 bonus_threshold만큼 한 번 연장한다.
+    // 한 층의 상태 중 consensus_ratio 이상이 같은 첫 행동을 가지면 더 깊이 보지 않고 바로 반환한다.
+    // 1.0이면 모든 상태가 같은 경우에만 멈추므로 결과는 바뀌지 않는다. (자손도 모두 같은 첫 행동을 가진다)
+    int beamSearchActionWithTimeKeeper(const State &state, const int beam_width, TimeKeeper &time_keeper,
+                                       const int64_t bonus_threshold = 0, const double consensus_ratio = 1.0) {
+        std::priority_queue<State> now_beam;
+        State best_state;
+        int stable_layer_count = 0;
+        bool is_extended = false;
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            std::priority_queue<State> next_beam;
+            // 다음 층에 넣은 상태의 첫 행동별 개수
+            int votes[4] = {};
+            for (int i = 0; i < beam_width; ++i) {
+                // 첫 층은 행동을 고르기 위해 항상 끝낸다.
+                if (t > 0 && time_keeper.isTimeOver()) {
+                    if (is_extended || bonus_threshold <= 0 || stable_layer_count >= STABLE_LAYER_N) {
+                        return best_state.first_action_;
+                    }
+                    time_keeper.extend(bonus_threshold);
+                    is_extended = true;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    votes[next_state.first_action_]++;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = std::move(next_beam);
+            const int previous_action = best_state.first_action_;
+            best_state = now_beam.top();
+            stable_layer_count = best_state.first_action_ == previous_action ? stable_layer_count + 1 : 0;
+
+            if (best_state.isDone()) { break; }
+            if (votes[best_state.first_action_] >= consensus_ratio * now_beam.size()) { break; }
+        }
+        return best_state.first_action_;
+    }
+
+    enum class TimeAllocation {
+        // 남은 시간을 남은 턴 수로 똑같이 나눈다.
+        Uniform,
+        // 초반 턴에 더 많이 주고 뒤로 갈수록 줄인다.
+        FrontLoaded,
+    };
+
+    // 게임 전체의 시간 제한을 턴마다 나눠 준다.
+    class GameTimeManager {
+    private:
+        double remain_ms_;
+        TimeAllocation allocation_;
+        // 결정이 안정되지 않은 턴에 기본 할당량의 몇 배를 더 줄지
+        double bonus_ratio_;
+
+    public:
+        GameTimeManager(const int64_t game_time_threshold, const TimeAllocation allocation,
+                        const double bonus_ratio = 0.5)
+            : remain_ms_((double) game_time_threshold), allocation_(allocation), bonus_ratio_(bonus_ratio) {
+        }
+
+        // 이번 턴의 기본 시간 제한 (밀리초)
+        int64_t turnThreshold(const int turn) const {
+            const int remain_turn = END_TURN - turn;
+            if (remain_turn <= 0 || this->remain_ms_ <= 0) { return 0; }
+            double slice = this->remain_ms_ / remain_turn;
+            if (this->allocation_ == TimeAllocation::FrontLoaded) {
+                // 남은 턴 수가 n이면 남은 시간의 2/(n+1)을 쓴다. 턴이 지날수록 완만하게 줄어든다.
+                slice = this->remain_ms_ * 2 / (remain_turn + 1);
+            }
+            return (int64_t) slice;
+        }
+
+        // 결정이 안정되지 않았을 때 추가로 쓸 수 있는 시간.
+        // 남은 턴들이 각자 기본 할당량의 절반은 받을 수 있도록 남겨 둔다.
+        int64_t bonusThreshold(const int turn) const {
+            const int remain_turn = END_TURN - turn;
+            if (remain_turn <= 1) { return 0; }
+            const int64_t slice = this->turnThreshold(turn);
+            const double spare = this->remain_ms_ - slice - (this->remain_ms_ / remain_turn) * 0.5 * (remain_turn - 1);
+            return (int64_t) std::max(0.0, std::min(slice * this->bonus_ratio_, spare));
+        }
+
+        TimeKeeper startTurn(const int turn) const {
+            return TimeKeeper(this->turnThreshold(turn));
+        }
+
+        void endTurn(const TimeKeeper &time_keeper) {
+            this->remain_ms_ -= time_keeper.elapsedMilliseconds();
+        }
+
+        double remainMilliseconds() const {
+            return this->remain_ms_;
+        }
+    };
+
+    void testAiScoreWithTimeManager(const int game_number, const int64_t game_time_threshold,
+                                    const TimeAllocation allocation) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            GameTimeManager time_manager(game_time_threshold, allocation);
+            while (!state.isDone()) {
+                auto time_keeper = time_manager.startTurn(state.turn());
+                const int64_t bonus_threshold = time_manager.bonusThreshold(state.turn());
+                state.advance(beamSearchActionWithTimeKeeper(state, 5, time_keeper, bonus_threshold));
+                time_manager.endTurn(time_keeper);
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+
+    // 이전 층과 이전 턴에서 측정한 전개 속도로, 남은 시간 안에 목표 깊이까지 끝낼 수 있는 빔 너비를 정한다.
+    class BeamWidthController {
+    private:
+        // 한 층에서 전개한 노드 수 / 걸린 밀리초의 지수 이동 평균
+        double nodes_per_ms_;
+        int min_width_;
+        int max_width_;
+        // 측정 오차와 부하 변동을 감안해 남은 시간 중 이 비율만 쓰도록 계획한다.
+        static constexpr const double SAFETY{0.8};
+        static constexpr const double SMOOTHING{0.3};
+
+    public:
+        int64_t completed_count_{0};
+        int64_t truncated_count_{0};
+
+        BeamWidthController(const int min_width = 1, const int max_width = 1 << 16,
+                            const double initial_nodes_per_ms = 100)
+            : nodes_per_ms_(initial_nodes_per_ms), min_width_(min_width), max_width_(max_width) {
+        }
+
+        void update(const int64_t node_count, const double elapsed_ms) {
+            // 너무 짧은 구간은 타이머 해상도 때문에 믿을 수 없다.
+            if (node_count <= 0 || elapsed_ms < 0.01) { return; }
+            this->nodes_per_ms_ += SMOOTHING * (node_count / elapsed_ms - this->nodes_per_ms_);
+        }
+
+        int width(const double remain_ms, const int remain_depth) const {
+            if (remain_depth <= 0) { return this->min_width_; }
+            double width = this->nodes_per_ms_ * remain_ms * SAFETY / remain_depth;
+            return (int) std::clamp<double>(width, this->min_width_, this->max_width_);
+        }
+
+        double nodesPerMs() const {
+            return this->nodes_per_ms_;
+        }
+    };
+
+    // beam_depth 층 (또는 게임 끝) 까지 끝낼 수 있도록 층마다 빔 너비를 다시 정한다.
+    // 그래도 시간이 다 되면 마지막으로 끝낸 층의 최선을 반환한다. 첫 층은 시간이 지나도 끝낸다.
+    int beamSearchActionWithAdaptiveWidth(const State &state, const int64_t time_threshold, const int beam_depth,
+                                          BeamWidthController &controller) {
+        auto time_keeper = TimeKeeper(time_threshold);
+        const int plan_depth = std::min(beam_depth, END_TURN - state.turn());
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+        // 남은 여유 시간을 마지막 몇 층에 몰아서 쓰면 예측이 조금만 어긋나도 시간을 넘기므로
+        // 너비는 늦어졌을 때 줄이기만 하고 늘리지는 않는다.
+        int beam_width = std::numeric_limits<int>::max();
+
+        now_beam.push(state);
+        for (int t = 0; t < plan_depth; t++) {
+            const double layer_start_ms = time_keeper.elapsedMilliseconds();
+            beam_width = std::min(beam_width, controller.width(time_threshold - layer_start_ms, plan_depth - t));
+            std::priority_queue<State> next_beam;
+            int64_t node_count = 0;
+            for (int i = 0; i < beam_width; ++i) {
+                // 첫 층은 행동을 고르기 위해 항상 끝낸다.
+                if (t > 0 && time_keeper.isTimeOver()) {
+                    controller.update(node_count, time_keeper.elapsedMilliseconds() - layer_start_ms);
+                    controller.truncated_count_++;
+                    return best_state.first_action_;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                node_count++;
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = std::move(next_beam);
+            best_state = now_beam.top();
+            // 층을 넘기는 비용까지 포함해서 속도를 잰다.
+            controller.update(node_count, time_keeper.elapsedMilliseconds() - layer_start_ms);
+
+            if (best_state.isDone()) { break; }
+        }
+        controller.completed_count_++;
+        return best_state.first_action_;
+    }
+
+    void testAiScoreWithAdaptiveWidth(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        BeamWidthController controller;
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                state.advance(beamSearchActionWithAdaptiveWidth(state, 10, END_TURN, controller));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+        std::cout << "Completed:\t" << controller.completed_count_ << "\n";
+        std::cout << "Truncated:\t" << controller.truncated_count_ << "\n";
+        std::cout << "Nodes/ms:\t" << controller.nodesPerMs() << "\n";
+    }
+
+    // 층마다 캐릭터 위치별로 몇 개의 상태를 남겼는지 센다.
+    // 층 번호를 함께 기록해서 층이 바뀔 때 배열 전체를 지우지 않는다.
+    class CellCounter {
+    private:
+        int layer_[H * W] = {};
+        int count_[H * W] = {};
+        int now_layer_{0};
+
+    public:
+        void nextLayer() {
+            this->now_layer_++;
+        }
+
+        // 이 칸의 상태를 하나 더 남길 수 있으면 개수를 늘리고 true를 반환한다.
+        bool tryAdd(const Coord &character, const int cap) {
+            const int cell = character.y_ * W + character.x_;
+            if (this->layer_[cell] != this->now_layer_) {
+                this->layer_[cell] = this->now_layer_;
+                this->count_[cell] = 0;
+            }
+            if (this->count_[cell] >= cap) { return false; }
+            this->count_[cell]++;
+            return true;
+        }
+    };
+
+    // 같은 칸에 있는 상태는 층마다 cell_cap개까지만 전개해서 빔이 몇 개의 위치로 몰리지 않게 한다.
+    int beamSearchActionWithDiversity(const State &state, const int beam_width, const int64_t time_threshold,
+                                      const int cell_cap) {
+        auto time_keeper = TimeKeeper(time_threshold);
+        CellCounter cell_counter;
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            std::priority_queue<State> next_beam;
+            cell_counter.nextLayer();
+            for (int i = 0; i < beam_width;) {
+                if (time_keeper.isTimeOver()) {
+                    return best_state.first_action_;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                if (!cell_counter.tryAdd(now_state.character_, cell_cap)) { continue; }
+                ++i;
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = next_beam;
+            best_state = now_beam.top();
+
+            if (best_state.isDone()) { break; }
+        }
+        return best_state.first_action_;
+    }
+
+    void testAiScoreWithDiversity(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                state.advance(beamSearchActionWithDiversity(state, 5, 10, 1));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+
+    // 칸마다 남은 턴 수별로 얻을 수 있는 점수의 상한을 미리 계산해 둔다.
+    // 남은 턴이 r이면 거리 r 이내의 칸 중 점수가 높은 r개를 모두 얻는 것이 최대이다.
+    // 점수는 줄어들기만 하므로 게임 시작 시점의 게임판으로 한 번 만들면 게임 내내 상한으로 쓸 수 있다.
+    class BoundTable {
+    private:
+        std::vector<uint16_t> bound_;
+
+    public:
+        void build(const State &state) {
+            this->bound_.assign(H * W * (END_TURN + 1), 0);
+            // count[d][v] = 거리 d에 있는 점수 v인 칸의 개수
+            std::vector<std::array<int, 10> > count(H + W);
+            for (int cy = 0; cy < H; cy++) {
+                for (int cx = 0; cx < W; cx++) {
+                    for (auto &row: count) { row.fill(0); }
+                    for (int y = 0; y < H; y++) {
+                        for (int x = 0; x < W; x++) {
+                            count[std::abs(y - cy) + std::abs(x - cx)][state.point(y, x)]++;
+                        }
+                    }
+                    std::array<int, 10> reachable{};
+                    uint16_t *bound = &this->bound_[(cy * W + cx) * (END_TURN + 1)];
+                    for (int r = 0; r <= END_TURN; r++) {
+                        if (r < H + W) {
+                            for (int v = 0; v < 10; v++) { reachable[v] += count[r][v]; }
+                        }
+                        int rest = r;
+                        int sum = 0;
+                        for (int v = 9; v > 0 && rest > 0; v--) {
+                            int take = std::min(rest, reachable[v]);
+                            sum += take * v;
+                            rest -= take;
+                        }
+                        bound[r] = static_cast<uint16_t>(sum);
+                    }
+                }
+            }
+        }
+
+        // state에서 게임이 끝날 때까지 얻을 수 있는 최종 점수의 상한
+        ScoreType upperBound(const State &state) const {
+            const int cell = state.character_.y_ * W + state.character_.x_;
+            return state.game_score_ + this->bound_[cell * (END_TURN + 1) + END_TURN - state.turn()];
+        }
+    };
+
+    // 탐욕법으로 끝까지 진행한 점수. 가지치기의 기준이 되는 하한으로 쓴다. first_action에는 그 첫 행동을 넣는다.
+    ScoreType greedyPlayoutScore(State state, int &first_action) {
+        first_action = -1;
+        while (!state.isDone()) {
+            const int action = greedyAction(state);
+            if (first_action == -1) { first_action = action; }
+            state.advance(action);
+        }
+        return state.game_score_;
+    }
+
+    // 상한이 이미 확보한 최종 점수 이하인 자식은 다음 층에 넣기 전에 버린다.
+    // 확보한 최종 점수(하한)를 내는 첫 행동도 함께 기억해 두고, 모든 자식이 잘리면 그 행동을 반환한다.
+    int beamSearchActionWithPruning(const State &state, const int beam_width, const int64_t time_threshold,
+                                    const BoundTable &bound_table, int64_t &pruned_count) {
+        auto time_keeper = TimeKeeper(time_threshold);
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+        int lower_bound_action = -1;
+        ScoreType lower_bound = greedyPlayoutScore(state, lower_bound_action);
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            std::priority_queue<State> next_beam;
+            for (int i = 0; i < beam_width; ++i) {
+                if (time_keeper.isTimeOver()) {
+                    return best_state.first_action_ == -1 ? lower_bound_action : best_state.first_action_;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    // 첫 층은 행동을 고르기 위해 남겨 둔다.
+                    if (t > 0 && bound_table.upperBound(next_state) <= lower_bound) {
+                        pruned_count++;
+                        continue;
+                    }
+                    if (next_state.isDone() && next_state.game_score_ > lower_bound) {
+                        lower_bound = next_state.game_score_;
+                        lower_bound_action = next_state.first_action_;
+                    }
+                    next_state.evaluateScore();
+                    next_beam.push(next_state);
+                }
+            }
+            // 모든 자식이 잘렸으면 남은 어떤 수순도 하한을 넘지 못하므로 하한을 내는 행동이 답이다.
+            if (next_beam.empty()) { return lower_bound_action; }
+
+            now_beam = next_beam;
+            best_state = now_beam.top();
+
+            if (best_state.isDone()) { break; }
+        }
+        return best_state.first_action_;
+    }
+
+    void testAiScoreWithPruning(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        int64_t pruned_count{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            BoundTable bound_table;
+            bound_table.build(state);
+            while (!state.isDone()) {
+                state.advance(beamSearchActionWithPruning(state, 5, 10, bound_table, pruned_count));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+        std::cout << "Pruned:\t" << pruned_count << "\n";
+    }
+
+    void testAiScoreWithTreeReuse(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            SearchTree tree;
+            while (!state.isDone()) {
+                int action = beamSearchActionWithTimeThreshold(state, 5, 10, tree);
+                state.advance(action);
+                tree.promote(action);
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+
+    // beamSearchActionWithTimeThreshold를 stop_token으로 언제든 멈출 수 있게 한 것. 층을 끝낼 때마다 최선을 알린다.
+    void beamSearchActionAsync(const State &state, const int beam_width, const int64_t time_threshold,
+                               const std::stop_token &stop_token,
+                               AsyncSearch::SearchTask<AsyncSearch::ActionScore> &task) {
+        auto time_keeper = TimeKeeper(time_threshold);
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            std::priority_queue<State> next_beam;
+            for (int i = 0; i < beam_width; ++i) {
+                if (stop_token.stop_requested() || time_keeper.isTimeOver()) { return; }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = std::move(next_beam);
+            best_state = now_beam.top();
+            task.publish(AsyncSearch::ActionScore{best_state.first_action_, best_state.evaluated_score_});
+
+            if (best_state.isDone()) { break; }
+        }
+    }
+
+    void startBeamSearch(AsyncSearch::SearchTask<AsyncSearch::ActionScore> &task, const State &state,
+                         const int beam_width, const int64_t time_threshold) {
+        task.start([state, beam_width, time_threshold](const std::stop_token &stop_token, auto &task) {
+            beamSearchActionAsync(state, beam_width, time_threshold, stop_token, task);
+        });
+    }
+
+    // 탐색을 백그라운드에서 돌리고 프레임 마감 시각에 취소한 뒤 그때까지의 최선을 사용한다.
+    void testAiScoreAsync(const int game_number, const int64_t frame_threshold) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        AsyncSearch::SearchTask<AsyncSearch::ActionScore> task;
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                startBeamSearch(task, state, 5, INF);
+                std::this_thread::sleep_for(std::chrono::milliseconds(frame_threshold));
+                task.cancel();
+                auto best = task.poll();
+                state.advance(best ? best->action_ : randomAction(state));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+
+    // beamSearchActionWithTimeThreshold를 코루틴으로 만든 것. 깊이마다 스케줄러에 양보한다.
+    // 다른 세션을 기다리다 시간을 다 쓸 수도 있으므로 첫 깊이는 시간과 관계없이 끝까지 전개한다.
+    // 코루틴이 끝날 때까지 인자가 살아 있도록 값으로 받는다.
+    SessionScheduler::Task<int> beamSearchActionCoroutine(const State state, const int beam_width,
+                                                          const int64_t time_threshold) {
+        auto time_keeper = TimeKeeper(time_threshold);
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            std::priority_queue<State> next_beam;
+            for (int i = 0; i < beam_width; ++i) {
+                if (t > 0 && time_keeper.isTimeOver()) {
+                    co_return best_state.first_action_;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = std::move(next_beam);
+            best_state = now_beam.top();
+
+            if (best_state.isDone()) { break; }
+            co_await SessionScheduler::yield();
+        }
+        co_return best_state.first_action_;
+    }
+
+    // 한 게임을 세션 하나로 진행한다. 수마다 마감 시각을 time_threshold 뒤로 잡는다.
+    SessionScheduler::Task<void> playGameSession(const int seed, const int beam_width, const int64_t time_threshold,
+                                                 int &score) {
+        auto state = State(seed);
+        while (!state.isDone()) {
+            co_await SessionScheduler::setDeadline(time_threshold);
+            state.advance(co_await beamSearchActionCoroutine(state, beam_width, time_threshold));
+        }
+        score = state.game_score_;
+    }
+
+    // game_number개의 게임을 동시에 진행하고 thread_n개의 스레드가 번갈아 실행한다.
+    void testAiScoreWithScheduler(const int game_number, const int thread_n) {
+        std::mt19937 mt_for_construct(0);
+        std::vector<int> scores(game_number);
+        {
+            SessionScheduler::Scheduler scheduler(thread_n);
+            for (int i = 0; i < game_number; i++) {
+                scheduler.spawn(playGameSession(mt_for_construct(), 5, 10, scores[i]));
+            }
+            scheduler.waitAll();
+            for (const auto &[id, exception]: scheduler.takeFailures()) {
+                try {
+                    std::rethrow_exception(exception);
+                } catch (const std::exception &e) {
+                    std::cerr << "session " << id << " failed: " << e.what() << "\n";
+                }
+            }
+        }
+        double score_mean{0};
+        for (const auto score: scores) {
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+
     void testAiScore(const int game_number) {
         std::mt19937 mt_for_construct(0);
         double score_mean{0};
@@ -0,0 +1,530 @@
+//
+// Created by eu on 2026-10-19.
+//
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BoardGenerator.h"
+
+namespace BoardFormat {
+    using ScoreType = int64_t;
+    constexpr const ScoreType INF = 1000000000LL;
+
+    struct Coord {
+        int y_;
+        int x_;
+
+        Coord(const int y = 0, const int x = 0): y_(y), x_(x) {
+        }
+    };
+
+    constexpr const int H{30};
+    constexpr const int W{30};
+    constexpr int END_TURN{100};
+
+    // 칸 점수(0~9)는 4비트, 행동(0~3)은 2비트로 묶어서 저장한다.
+    constexpr const int PACKED_CELL_BYTES{(H * W + 1) / 2};
+    constexpr const int PACKED_ACTION_BYTES{(END_TURN + 3) / 4};
+
+    // 코퍼스에 들어 있는 레코드의 종류. 레코드의 board_id_를 어떻게 읽을지 정한다.
+    enum class CorpusKind : uint16_t {
+        // 리플레이. board_id_는 State(seed)의 seed
+        Replay = 1,
+        // 생성한 게임판. board_id_는 BoardGenerator::generateBoard(generator_seed_, board_id_, ...)의 index
+        Generated = 2,
+    };
+
+    // 파일 맨 앞에 한 번만 기록하는 헤더
+    struct FileHeader {
+        char magic_[4];
+        uint16_t version_;
+        uint8_t height_;
+        uint8_t width_;
+        uint16_t end_turn_;
+        CorpusKind kind_;
+        uint32_t record_size_;
+        uint64_t record_count_;
+        // Generated 코퍼스를 만든 BoardGenerator의 seed (Replay이면 0)
+        uint64_t generator_seed_;
+    };
+
+    // 게임판 하나(와 리플레이)마다 붙는 헤더
+    struct RecordHeader {
+        uint64_t board_id_;
+        uint8_t start_y_;
+        uint8_t start_x_;
+        uint16_t action_count_;
+        int32_t final_score_;
+    };
+
+    constexpr const char MAGIC[4] = {'M', 'Z', 'B', 'D'};
+    // 2: 코퍼스 종류와 생성 seed를 기록하고 board_id_를 64비트로 늘렸다.
+    constexpr const uint16_t VERSION{2};
+    // 모든 레코드의 크기가 같으므로 i번째 게임판은 오프셋 계산만으로 찾을 수 있다.
+    constexpr const uint32_t RECORD_SIZE{sizeof(RecordHeader) + PACKED_CELL_BYTES + PACKED_ACTION_BYTES};
+
+    static_assert(sizeof(FileHeader) == 32);
+    static_assert(sizeof(RecordHeader) == 16);
+    static_assert(H < 256 && W < 256 && END_TURN < 65536);
+
+    class State {
+    private:
+        int points_[H][W] = {};
+        int turn_{0};
+
+        static constexpr const int dx[4] = {1, -1, 0, 0};
+        static constexpr const int dy[4] = {0, 0, 1, -1};
+
+    public:
+        Coord character_ = Coord(0, 0);
+        int game_score_ = 0;
+
+        State() = default;
+
+        State(const int seed) {
+            auto mt_for_construct = std::mt19937(seed);
+            this->character_.y_ = mt_for_construct() % H;
+            this->character_.x_ = mt_for_construct() % W;
+
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    if (y == character_.y_ && x == character_.x_) {
+                        continue;
+                    }
+                    this->points_[y][x] = mt_for_construct() % 10;
+                }
+            }
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        void advance(const int action) {
+            this->character_.x_ += dx[action];
+            this->character_.y_ += dy[action];
+            auto &point = this->points_[this->character_.y_][this->character_.x_];
+            if (point > 0) {
+                this->game_score_ += point;
+                point = 0;
+            }
+            this->turn_++;
+        }
+
+        // 현재 상황에서 플레이어가 가능한 행동을 모두 획득한다.
+        std::vector<int> legalActions() const {
+            std::vector<int> actions;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions.emplace_back(action);
+                }
+            }
+            return actions;
+        }
+
+        // 현재 게임 상황을 문자열로 만든다.
+        std::string toString() const {
+            std::stringstream ss;
+            ss << "turn:\t" << this->turn_ << "\n";
+            ss << "score:\t" << this->game_score_ << "\n";
+            for (int h = 0; h < H; h++) {
+                for (int w = 0; w < W; w++) {
+                    if (this->character_.y_ == h && this->character_.x_ == w) {
+                        ss << '@';
+                    } else if (this->points_[h][w] > 0) {
+                        ss << points_[h][w];
+                    } else {
+                        ss << ".";
+                    }
+                }
+                ss << "\n";
+            }
+            return ss.str();
+        }
+
+        // 게임판을 4비트 단위로 묶어서 기록한다. (짝수 칸은 하위 4비트, 홀수 칸은 상위 4비트)
+        void packBoard(uint8_t *cells) const {
+            std::memset(cells, 0, PACKED_CELL_BYTES);
+            for (int i = 0; i < H * W; i++) {
+                auto point = static_cast<uint8_t>(this->points_[i / W][i % W]);
+                cells[i >> 1] |= (i & 1) ? (point << 4) : point;
+            }
+        }
+
+        // 묶여 있는 게임판을 풀어서 처음 상태로 되돌린다. 힙 할당은 하지 않는다.
+        void unpackBoard(const uint8_t *cells, const Coord &character) {
+            for (int i = 0; i < H * W; i++) {
+                auto packed = cells[i >> 1];
+                this->points_[i / W][i % W] = (i & 1) ? (packed >> 4) : (packed & 0x0F);
+            }
+            this->character_ = character;
+            this->turn_ = 0;
+            this->game_score_ = 0;
+        }
+    };
+
+    std::mt19937 mt_for_action(0);
+
+    int greedyAction(const State &state) {
+        auto legal_actions = state.legalActions();
+        ScoreType best_score = -INF;
+        int best_action = -1;
+        for (const auto action: legal_actions) {
+            State now_state = state;
+            now_state.advance(action);
+            if (now_state.game_score_ > best_score) {
+                best_score = now_state.game_score_;
+                best_action = action;
+            }
+        }
+        assert(best_action !=-1);
+        return best_action;
+    }
+
+    // 매핑된 파일 위의 레코드 하나를 그대로 읽는 뷰. 파싱이나 복사 없이 필요한 칸만 꺼낸다.
+    class RecordView {
+    private:
+        const uint8_t *data_;
+
+    public:
+        explicit RecordView(const uint8_t *data): data_(data) {
+        }
+
+        // RECORD_SIZE가 홀수라 헤더가 정렬되어 있지 않을 수 있으므로 복사해서 꺼낸다.
+        RecordHeader header() const {
+            RecordHeader header;
+            std::memcpy(&header, this->data_, sizeof(header));
+            return header;
+        }
+
+        const uint8_t *cells() const {
+            return this->data_ + sizeof(RecordHeader);
+        }
+
+        int cell(const int y, const int x) const {
+            const int i = y * W + x;
+            auto packed = this->cells()[i >> 1];
+            return (i & 1) ? (packed >> 4) : (packed & 0x0F);
+        }
+
+        int actionCount() const {
+            return this->header().action_count_;
+        }
+
+        int action(const int i) const {
+            assert(0 <= i && i < this->actionCount() && i < END_TURN);
+            auto packed = this->cells()[PACKED_CELL_BYTES + (i >> 2)];
+            return (packed >> ((i & 3) * 2)) & 0x03;
+        }
+
+        // 기존 State를 재사용해서 게임판을 채운다.
+        void loadInto(State &state) const {
+            const auto header = this->header();
+            state.unpackBoard(this->cells(), Coord(header.start_y_, header.start_x_));
+        }
+    };
+
+    FileHeader makeFileHeader(const CorpusKind kind, const uint64_t record_count, const uint64_t generator_seed = 0) {
+        FileHeader header{};
+        std::memcpy(header.magic_, MAGIC, sizeof(MAGIC));
+        header.version_ = VERSION;
+        header.height_ = H;
+        header.width_ = W;
+        header.end_turn_ = END_TURN;
+        header.kind_ = kind;
+        header.record_size_ = RECORD_SIZE;
+        header.record_count_ = record_count;
+        header.generator_seed_ = generator_seed;
+        return header;
+    }
+
+    // 게임판과 리플레이를 고정 크기 레코드로 이어 붙여 기록한다.
+    class CorpusWriter {
+    private:
+        std::ofstream ofs_;
+        uint64_t record_count_{0};
+        uint8_t buffer_[RECORD_SIZE] = {};
+
+    public:
+        explicit CorpusWriter(const std::string &path): ofs_(path, std::ios::binary | std::ios::trunc) {
+            // 레코드 개수는 close()에서 다시 기록한다.
+            this->writeFileHeader();
+        }
+
+        ~CorpusWriter() {
+            this->close();
+        }
+
+        bool isOpen() const {
+            return this->ofs_.is_open() && this->ofs_.good();
+        }
+
+        // 열기나 쓰기에 실패했는지. close() 후에도 확인할 수 있다.
+        bool isFailed() const {
+            return this->ofs_.fail();
+        }
+
+        // 초기 게임판과 그 뒤에 실행한 행동열을 기록한다. 행동이 없으면 게임판만 기록한다.
+        void write(const State &initial_state, const uint32_t seed,
+                   const std::vector<int> &actions = {}, const int final_score = 0) {
+            assert(actions.size() <= END_TURN);
+            std::memset(this->buffer_, 0, RECORD_SIZE);
+            RecordHeader header{};
+            header.board_id_ = seed;
+            header.start_y_ = static_cast<uint8_t>(initial_state.character_.y_);
+            header.start_x_ = static_cast<uint8_t>(initial_state.character_.x_);
+            header.action_count_ = static_cast<uint16_t>(actions.size());
+            header.final_score_ = final_score;
+            std::memcpy(this->buffer_, &header, sizeof(header));
+
+            uint8_t *cells = this->buffer_ + sizeof(RecordHeader);
+            initial_state.packBoard(cells);
+            uint8_t *packed_actions = cells + PACKED_CELL_BYTES;
+            for (int i = 0; i < (int) actions.size(); i++) {
+                packed_actions[i >> 2] |= static_cast<uint8_t>(actions[i] << ((i & 3) * 2));
+            }
+            this->ofs_.write(reinterpret_cast<const char *>(this->buffer_), RECORD_SIZE);
+            this->record_count_++;
+        }
+
+        void close() {
+            if (!this->ofs_.is_open()) { return; }
+            this->ofs_.seekp(0);
+            this->writeFileHeader();
+            this->ofs_.close();
+        }
+
+    private:
+        void writeFileHeader() {
+            const auto header = makeFileHeader(CorpusKind::Replay, this->record_count_);
+            this->ofs_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        }
+    };
+
+    // 코퍼스 파일 전체를 mmap해서 레코드를 순회한다.
+    class MappedCorpus {
+    private:
+        const uint8_t *data_{nullptr};
+        size_t length_{0};
+        uint64_t record_count_{0};
+        CorpusKind kind_{CorpusKind::Replay};
+        uint64_t generator_seed_{0};
+
+    public:
+        MappedCorpus() = default;
+        MappedCorpus(const MappedCorpus &) = delete;
+        MappedCorpus &operator=(const MappedCorpus &) = delete;
+
+        ~MappedCorpus() {
+            this->close();
+        }
+
+        // 헤더가 현재 게임 설정과 맞지 않으면 false를 반환한다.
+        bool open(const std::string &path) {
+            this->close();
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) { return false; }
+            struct stat st{};
+            if (::fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(FileHeader)) {
+                ::close(fd);
+                return false;
+            }
+            void *mapped = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapped == MAP_FAILED) { return false; }
+            ::madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+            this->data_ = static_cast<const uint8_t *>(mapped);
+            this->length_ = st.st_size;
+
+            const auto &header = *reinterpret_cast<const FileHeader *>(this->data_);
+            if (std::memcmp(header.magic_, MAGIC, sizeof(MAGIC)) != 0 || header.version_ != VERSION ||
+                header.height_ != H || header.width_ != W || header.end_turn_ != END_TURN ||
+                (header.kind_ != CorpusKind::Replay && header.kind_ != CorpusKind::Generated) ||
+                header.record_size_ != RECORD_SIZE ||
+                // 손상된 record_count_로 곱셈이 넘치지 않도록 나눗셈으로 비교한다.
+                header.record_count_ > (this->length_ - sizeof(FileHeader)) / RECORD_SIZE) {
+                this->close();
+                return false;
+            }
+            this->record_count_ = header.record_count_;
+            this->kind_ = header.kind_;
+            this->generator_seed_ = header.generator_seed_;
+            return true;
+        }
+
+        void close() {
+            if (this->data_ != nullptr) {
+                ::munmap(const_cast<uint8_t *>(this->data_), this->length_);
+            }
+            this->data_ = nullptr;
+            this->length_ = 0;
+            this->record_count_ = 0;
+        }
+
+        uint64_t size() const {
+            return this->record_count_;
+        }
+
+        CorpusKind kind() const {
+            return this->kind_;
+        }
+
+        uint64_t generatorSeed() const {
+            return this->generator_seed_;
+        }
+
+        RecordView operator[](const uint64_t i) const {
+            assert(i < this->record_count_);
+            return RecordView(this->data_ + sizeof(FileHeader) + i * RECORD_SIZE);
+        }
+    };
+
+    // 탐욕법으로 플레이한 결과를 리플레이로 남긴다. 파일을 열거나 쓰지 못하면 false를 반환한다.
+    bool writeCorpus(const std::string &path, const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        CorpusWriter writer(path);
+        if (!writer.isOpen()) { return false; }
+        std::vector<int> actions;
+        actions.reserve(END_TURN);
+        for (int i = 0; i < game_number; i++) {
+            const uint32_t seed = mt_for_construct();
+            const auto initial_state = State(seed);
+            auto state = initial_state;
+            actions.clear();
+            while (!state.isDone()) {
+                int action = greedyAction(state);
+                actions.emplace_back(action);
+                state.advance(action);
+            }
+            writer.write(initial_state, seed, actions, state.game_score_);
+        }
+        writer.close();
+        return !writer.isFailed();
+    }
+
+    // board_count개의 게임판을 병렬로 만들어 mmap한 파일에 바로 기록한다. (리플레이 없음)
+    // 파일 헤더에 seed를, 레코드의 board_id_에 게임판 번호를 기록하므로
+    // BoardGenerator::generateBoard(generatorSeed(), board_id_, H, W, ...)로 같은 게임판을 다시 만들 수 있다.
+    bool generateCorpus(const std::string &path, const uint64_t seed, const uint64_t board_count) {
+        if (board_count > (std::numeric_limits<off_t>::max() - sizeof(FileHeader)) / RECORD_SIZE) { return false; }
+        const size_t length = sizeof(FileHeader) + board_count * RECORD_SIZE;
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) { return false; }
+        // ftruncate로 늘리면 블록이 없는 파일이 되어 디스크가 가득 찼을 때 페이지에 쓰다가 SIGBUS가 난다.
+        // 블록을 미리 잡아 두고 실패하면 여기서 false를 반환한다.
+        if (::posix_fallocate(fd, 0, (off_t) length) != 0) {
+            ::close(fd);
+            return false;
+        }
+        void *mapped = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) { return false; }
+        auto *data = static_cast<uint8_t *>(mapped);
+
+        const auto file_header = makeFileHeader(CorpusKind::Generated, board_count, seed);
+        std::memcpy(data, &file_header, sizeof(file_header));
+        // 파일은 0으로 채워져 있으므로 행동 칸은 건드리지 않는다.
+        ThreadPool::parallelFor(0, (int64_t) board_count, 256, [&](const int64_t i) {
+            uint8_t *record = data + sizeof(FileHeader) + i * RECORD_SIZE;
+            uint8_t points[H * W + 1];
+            const int start = BoardGenerator::generateBoard(seed, i, H, W, points);
+            points[H * W] = 0;
+
+            RecordHeader header{};
+            header.board_id_ = static_cast<uint64_t>(i);
+            header.start_y_ = static_cast<uint8_t>(start / W);
+            header.start_x_ = static_cast<uint8_t>(start % W);
+            std::memcpy(record, &header, sizeof(header));
+            uint8_t *cells = record + sizeof(RecordHeader);
+            for (int c = 0; c < PACKED_CELL_BYTES; c++) {
+                cells[c] = static_cast<uint8_t>(points[2 * c] | (points[2 * c + 1] << 4));
+            }
+        });
+        return ::munmap(mapped, length) == 0;
+    }
+
+    // 게임판 생성 속도를 State(seed)와 비교하고 기록된 게임판이 파일의 seed와 번호로 다시 만든 게임판과 같은지 확인한다.
+    void testGenerateCorpus(const std::string &path, const uint64_t seed, const uint64_t board_count) {
+        using std::chrono::duration;
+        using std::chrono::high_resolution_clock;
+
+        auto start_time = high_resolution_clock::now();
+        int64_t checksum = 0;
+        for (uint64_t i = 0; i < board_count; i++) {
+            checksum += State((int) i).character_.x_;
+        }
+        const double state_seconds = duration<double>(high_resolution_clock::now() - start_time).count();
+
+        start_time = high_resolution_clock::now();
+        if (!generateCorpus(path, seed, board_count)) {
+            std::cout << "Failed to write corpus:\t" << path << "\n";
+            return;
+        }
+        const double generate_seconds = duration<double>(high_resolution_clock::now() - start_time).count();
+
+        MappedCorpus corpus;
+        int mismatch{0};
+        if (corpus.open(path) && corpus.kind() == CorpusKind::Generated) {
+            uint8_t points[H * W];
+            for (uint64_t i = 0; i < corpus.size(); i += std::max<uint64_t>(1, corpus.size() / 100)) {
+                const auto record = corpus[i];
+                const int start = BoardGenerator::generateBoard(corpus.generatorSeed(), record.header().board_id_, H, W,
+                                                                points);
+                if (start != record.header().start_y_ * W + record.header().start_x_) { mismatch++; }
+                for (int c = 0; c < H * W; c++) {
+                    if (record.cell(c / W, c % W) != points[c]) {
+                        mismatch++;
+                        break;
+                    }
+                }
+            }
+        }
+        std::cout << "State boards/sec:\t" << board_count / state_seconds << " (" << checksum << ")\n";
+        std::cout << "Generated boards/sec:\t" << board_count / generate_seconds << "\n";
+        std::cout << "Boards:\t" << corpus.size() << "\n";
+        std::cout << "Mismatch:\t" << mismatch << "\n";
+    }
+
+    // 코퍼스의 리플레이를 다시 실행해서 기록된 점수와 일치하는지 확인한다.
+    void testCorpusScore(const std::string &path) {
+        MappedCorpus corpus;
+        if (!corpus.open(path)) {
+            std::cout << "Failed to open corpus:\t" << path << "\n";
+            return;
+        }
+        State state;
+        double score_mean{0};
+        int mismatch{0};
+        for (uint64_t i = 0; i < corpus.size(); i++) {
+            const auto record = corpus[i];
+            record.loadInto(state);
+            for (int t = 0; t < record.actionCount(); t++) {
+                state.advance(record.action(t));
+            }
+            if (state.game_score_ != record.header().final_score_) {
+                mismatch++;
+            }
+            score_mean += state.game_score_;
+        }
+        if (corpus.size() > 0) {
+            score_mean /= (double) corpus.size();
+        }
+        std::cout << "Boards:\t" << corpus.size() << "\n";
+        std::cout << "Score:\t" << score_mean << "\n";
+        std::cout << "Mismatch:\t" << mismatch << "\n";
+    }
+}
@@ -0,0 +1,74 @@
+//
+// Created by eu on 2026-10-19.
+//
+
+#ifndef GAME_BOARDGENERATOR_H
+#define GAME_BOARDGENERATOR_H
+
+#include <cstdint>
+#include "ThreadPool.h"
+
+namespace BoardGenerator {
+    constexpr const uint64_t GOLDEN_GAMMA{0x9E3779B97F4A7C15ULL};
+
+    // SplitMix64의 마무리 함수
+    inline uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // (seed, index)마다 독립된 카운터 기반 난수열. 앞의 게임판을 만들지 않고도 index번째 게임판을 다시 만들 수 있다.
+    class CounterRng {
+    private:
+        uint64_t key_;
+        uint64_t counter_{0};
+
+    public:
+        CounterRng(const uint64_t seed, const uint64_t index): key_(mix(seed ^ mix(index + GOLDEN_GAMMA))) {
+        }
+
+        uint64_t next() {
+            return mix(this->key_ + (++this->counter_) * GOLDEN_GAMMA);
+        }
+    };
+
+    // 16비트 난수를 [0, n) 범위로 옮긴다. (나눗셈 없이 곱셈과 시프트만 사용)
+    inline uint8_t scale16(const uint64_t bits, const uint32_t n) {
+        return static_cast<uint8_t>(((bits & 0xFFFF) * n) >> 16);
+    }
+
+    // 칸 점수가 0~9인 h*w 게임판 하나를 points에 채우고 시작 칸 번호를 반환한다. 시작 칸의 점수는 0이다.
+    // 난수 하나로 네 칸씩 채운다.
+    inline int generateBoard(const uint64_t seed, const uint64_t index, const int h, const int w, uint8_t *points) {
+        CounterRng rng(seed, index);
+        const int cell_n = h * w;
+        const int start = static_cast<int>(((rng.next() >> 32) * static_cast<uint64_t>(cell_n)) >> 32);
+        int c = 0;
+        for (; c + 4 <= cell_n; c += 4) {
+            const uint64_t bits = rng.next();
+            points[c] = scale16(bits, 10);
+            points[c + 1] = scale16(bits >> 16, 10);
+            points[c + 2] = scale16(bits >> 32, 10);
+            points[c + 3] = scale16(bits >> 48, 10);
+        }
+        uint64_t bits = rng.next();
+        for (; c < cell_n; c++, bits >>= 16) {
+            points[c] = scale16(bits, 10);
+        }
+        points[start] = 0;
+        return start;
+    }
+
+    // first_index부터 count개의 게임판을 병렬로 만든다.
+    // 게임판 i는 points[i * h * w]부터 이어지고 시작 칸 번호는 starts[i]에 들어간다.
+    inline void generateBoards(const uint64_t seed, const uint64_t first_index, const int64_t count,
+                               const int h, const int w, uint8_t *points, int32_t *starts) {
+        const int64_t cell_n = (int64_t) h * w;
+        ThreadPool::parallelFor(0, count, 64, [&](const int64_t i) {
+            starts[i] = generateBoard(seed, first_index + i, h, w, points + i * cell_n);
+        });
+    }
+}
+
+#endif //GAME_BOARDGENERATOR_H
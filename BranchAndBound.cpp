@@ -0,0 +1,263 @@
+//
+// Created by eu on 2026-10-19.
+//
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <iostream>
+#include <vector>
+#include <sstream>
+#include <unordered_map>
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+namespace BranchAndBound {
+    using ScoreType = int64_t;
+    constexpr const ScoreType INF = 1000000000LL;
+
+    struct Coord {
+        int y_;
+        int x_;
+
+        Coord(const int y = 0, const int x = 0): y_(y), x_(x) {
+        }
+    };
+
+    constexpr const int H{3};
+    constexpr const int W{4};
+    constexpr int END_TURN{4};
+
+    // 메모이제이션 키 = 남은 칸 비트마스크 | 캐릭터 위치 | 턴
+    constexpr const int CELL_BITS{H * W};
+    constexpr const int POSITION_BITS{std::bit_width(static_cast<unsigned>(H * W))};
+    constexpr const int TURN_BITS{std::bit_width(static_cast<unsigned>(END_TURN))};
+    static_assert(CELL_BITS + POSITION_BITS + TURN_BITS <= 64, "board is too large for exact search key");
+
+    class State {
+    private:
+        int points_[H][W] = {};
+        int turn_{0};
+
+        static constexpr const int dx[4] = {1, -1, 0, 0};
+        static constexpr const int dy[4] = {0, 0, 1, -1};
+
+    public:
+        Coord character_ = Coord(0, 0);
+        int game_score_ = 0;
+        // 아직 점수가 남아 있는 칸의 비트마스크
+        uint64_t remain_mask_{0};
+
+        State() = default;
+
+        State(const int seed) {
+            auto mt_for_construct = std::mt19937(seed);
+            this->character_.y_ = mt_for_construct() % H;
+            this->character_.x_ = mt_for_construct() % W;
+
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    if (y == character_.y_ && x == character_.x_) {
+                        continue;
+                    }
+                    this->points_[y][x] = mt_for_construct() % 10;
+                    if (this->points_[y][x] > 0) {
+                        this->remain_mask_ |= 1ULL << (y * W + x);
+                    }
+                }
+            }
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        int turn() const {
+            return this->turn_;
+        }
+
+        int point(const int y, const int x) const {
+            return this->points_[y][x];
+        }
+
+        void advance(const int action) {
+            this->character_.x_ += dx[action];
+            this->character_.y_ += dy[action];
+            auto &point = this->points_[this->character_.y_][this->character_.x_];
+            if (point > 0) {
+                this->game_score_ += point;
+                point = 0;
+                this->remain_mask_ &= ~(1ULL << (this->character_.y_ * W + this->character_.x_));
+            }
+            this->turn_++;
+        }
+
+        // 현재 상황에서 플레이어가 가능한 행동을 모두 획득한다.
+        std::vector<int> legalActions() const {
+            std::vector<int> actions;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions.emplace_back(action);
+                }
+            }
+            return actions;
+        }
+
+        // 남은 턴 동안 얻을 수 있는 점수의 상한.
+        // 한 턴에 최대 한 칸만 얻으므로 남은 턴 수 안에 닿는 칸 중 상위 k개의 합은 넘을 수 없다.
+        ScoreType upperBound() const {
+            const int remain_turn = END_TURN - this->turn_;
+            // 점수가 0~9로 작으므로 정렬 대신 점수별 개수를 센다.
+            int count[10] = {};
+            for (uint64_t mask = this->remain_mask_; mask != 0; mask &= mask - 1) {
+                int i = std::countr_zero(mask);
+                int y = i / W;
+                int x = i % W;
+                if (std::abs(y - this->character_.y_) + std::abs(x - this->character_.x_) <= remain_turn) {
+                    count[this->points_[y][x]]++;
+                }
+            }
+            ScoreType bound = 0;
+            int rest = remain_turn;
+            for (int point = 9; point > 0 && rest > 0; point--) {
+                int take = std::min(rest, count[point]);
+                bound += (ScoreType) take * point;
+                rest -= take;
+            }
+            return bound;
+        }
+
+        uint64_t hashKey() const {
+            uint64_t position = this->character_.y_ * W + this->character_.x_;
+            return this->remain_mask_ | (position << CELL_BITS) |
+                   (static_cast<uint64_t>(this->turn_) << (CELL_BITS + POSITION_BITS));
+        }
+
+        // 현재 게임 상황을 문자열로 만든다.
+        std::string toString() const {
+            std::stringstream ss;
+            ss << "turn:\t" << this->turn_ << "\n";
+            ss << "score:\t" << this->game_score_ << "\n";
+            for (int h = 0; h < H; h++) {
+                for (int w = 0; w < W; w++) {
+                    if (this->character_.y_ == h && this->character_.x_ == w) {
+                        ss << '@';
+                    } else if (this->points_[h][w] > 0) {
+                        ss << points_[h][w];
+                    } else {
+                        ss << ".";
+                    }
+                }
+                ss << "\n";
+            }
+            return ss.str();
+        }
+    };
+
+    // 분기 한정법으로 남은 턴에서 얻을 수 있는 최대 점수를 정확히 구한다.
+    class BranchAndBoundSolver {
+    private:
+        struct Entry {
+            ScoreType value_;
+            // false면 value_는 가지치기된 탐색에서 얻은 상한일 뿐이다.
+            bool is_exact_;
+        };
+
+        std::unordered_map<uint64_t, Entry> memo_;
+
+    public:
+        int64_t node_count_{0};
+
+        void clear() {
+            this->memo_.clear();
+            this->node_count_ = 0;
+        }
+
+        // state 이후에 얻을 수 있는 추가 점수의 최댓값을 반환한다.
+        // 반환값이 need 이하이면 그것은 정확한 값이 아니라 상한일 수 있다.
+        ScoreType search(const State &state, const ScoreType need) {
+            this->node_count_++;
+            if (state.isDone()) { return 0; }
+
+            const auto key = state.hashKey();
+            auto it = this->memo_.find(key);
+            if (it != this->memo_.end()) {
+                const auto &entry = it->second;
+                if (entry.is_exact_ || entry.value_ <= need) {
+                    return entry.value_;
+                }
+            }
+
+            const ScoreType bound = state.upperBound();
+            if (bound <= need) {
+                this->memo_[key] = Entry{bound, false};
+                return bound;
+            }
+
+            ScoreType best = -INF;
+            for (const auto action: state.legalActions()) {
+                State next_state = state;
+                next_state.advance(action);
+                const ScoreType gain = next_state.game_score_ - state.game_score_;
+                const ScoreType value = gain + this->search(next_state, std::max(need, best) - gain);
+                best = std::max(best, value);
+                if (best >= bound) { break; }
+            }
+            this->memo_[key] = Entry{best, best > need};
+            return best;
+        }
+
+        // 최적의 첫 행동과 그 때의 최종 점수를 구한다.
+        std::pair<int, ScoreType> solve(const State &state) {
+            this->clear();
+            int best_action = -1;
+            ScoreType best = -INF;
+            for (const auto action: state.legalActions()) {
+                State next_state = state;
+                next_state.advance(action);
+                const ScoreType gain = next_state.game_score_ - state.game_score_;
+                const ScoreType value = gain + this->search(next_state, best - gain);
+                if (value > best) {
+                    best = value;
+                    best_action = action;
+                }
+            }
+            return {best_action, state.game_score_ + best};
+        }
+    };
+
+    int branchAndBoundAction(const State &state) {
+        BranchAndBoundSolver solver;
+        auto [action, score] = solver.solve(state);
+        assert(action != -1);
+        return action;
+    }
+
+    // 게임 시작 시점에서 얻을 수 있는 최적 점수
+    ScoreType optimalScore(const State &state) {
+        BranchAndBoundSolver solver;
+        return solver.solve(state).second;
+    }
+
+    void playGame(const int seed) {
+        auto state = State(seed);
+        std::cout << state.toString() << "\n";
+        while (!state.isDone()) {
+            state.advance(branchAndBoundAction(state));
+            std::cout << state.toString() << "\n";
+        }
+    }
+
+    void testAiScore(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            score_mean += optimalScore(state);
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+}
@@ -8,6 +8,12 @@
 #include <sstream>
 #include <queue>
 #include <chrono>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include "Arena.h"
+#include "AsyncSearch.h"
+#include "SessionScheduler.h"
 
 namespace ChokudaiSearch {
     using ScoreType = int64_t;
@@ -55,6 +61,8 @@ namespace ChokudaiSearch {
     public:
         // 탐색 트리의 루트 노드에서 처음으로 선택한 행동
         int first_action_{-1};
+        // ChokudaiTree 안에서의 노드 번호 (-1이면 루트)
+        int node_id_{-1};
 
         bool operator<(const State &maze_1, const State &maze_2) const {
             return maze_1.evaluated_score_ < maze_2.evaluated_score_;
@@ -109,6 +117,19 @@ namespace ChokudaiSearch {
             return actions;
         }
 
+        // legalActions()와 같지만 힙 할당 없이 actions에 채우고 개수를 반환한다.
+        int legalActions(int (&actions)[4]) const {
+            int action_n = 0;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions[action_n++] = action;
+                }
+            }
+            return action_n;
+        }
+
         // 현재 게임 상황을 문자열로 만든다.
         std::string toString() const {
             std::stringstream ss;
@@ -139,6 +160,88 @@ namespace ChokudaiSearch {
         }
     };
 
+    // 탐색 트리의 노드. 부모 번호와 부모에서 선택한 행동만 기록한다.
+    struct SearchNode {
+        int parent_;
+        int action_;
+    };
+
+    // 이전 턴의 깊이별 빔을 다음 턴에 이어서 사용하기 위해 보관한다.
+    class ChokudaiTree {
+    public:
+        std::vector<SearchNode> nodes_;
+        // beam_[t]는 현재 루트에서 t 깊이에 있는 노드
+        std::vector<std::priority_queue<State> > beam_;
+
+        void clear() {
+            this->nodes_.clear();
+            this->beam_.clear();
+        }
+
+        int addNode(const int parent, const int action) {
+            this->nodes_.push_back(SearchNode{parent, action});
+            return (int) this->nodes_.size() - 1;
+        }
+
+        // 실제로 선택한 행동 아래의 서브트리를 새 루트로 올린다. 깊이가 하나씩 줄어든다.
+        void promote(const int action) {
+            if (this->beam_.empty()) { return; }
+            std::vector<std::vector<State> > layers(this->beam_.size());
+            for (size_t t = 1; t < this->beam_.size(); t++) {
+                auto &queue = this->beam_[t];
+                while (!queue.empty()) {
+                    layers[t].emplace_back(queue.top());
+                    queue.pop();
+                }
+            }
+
+            const int n = (int) this->nodes_.size();
+            std::vector<char> alive(n, 0);
+            for (const auto &layer: layers) {
+                for (const auto &state: layer) {
+                    for (int id = state.node_id_; id != -1 && !alive[id]; id = this->nodes_[id].parent_) {
+                        alive[id] = 1;
+                    }
+                }
+            }
+            // 부모는 항상 자식보다 먼저 추가되므로 한 번의 순회로 번호를 다시 매길 수 있다.
+            constexpr const int DROPPED{-2};
+            std::vector<int> remap(n, DROPPED);
+            std::vector<SearchNode> next_nodes;
+            std::vector<int> first_actions;
+            for (int id = 0; id < n; id++) {
+                if (!alive[id]) { continue; }
+                const auto &node = this->nodes_[id];
+                if (node.parent_ == -1) {
+                    if (node.action_ == action) { remap[id] = -1; }
+                    continue;
+                }
+                const int parent = remap[node.parent_];
+                if (parent == DROPPED) { continue; }
+                remap[id] = (int) next_nodes.size();
+                next_nodes.push_back(SearchNode{parent, node.action_});
+                first_actions.push_back(parent == -1 ? node.action_ : first_actions[parent]);
+            }
+
+            // 새 루트는 이미 전개되어 자식이 beam_[1]에 들어가 있으므로 beam_[0]은 비워 둔다.
+            for (auto &queue: this->beam_) {
+                queue = std::priority_queue<State>();
+            }
+            for (size_t t = 2; t < layers.size(); t++) {
+                for (auto &state: layers[t]) {
+                    // 루트(-1)는 beam_[0]에만 있으므로 여기에는 오지 않는다.
+                    assert(state.node_id_ >= 0);
+                    const int id = remap[state.node_id_];
+                    if (id < 0) { continue; }
+                    state.node_id_ = id;
+                    state.first_action_ = first_actions[id];
+                    this->beam_[t - 1].push(state);
+                }
+            }
+            this->nodes_.swap(next_nodes);
+        }
+    };
+
     std::mt19937 mt_for_action(0);
 
     int randomAction(const State &state) {
@@ -275,13 +378,91 @@ namespace ChokudaiSearch {
         return best_state.first_action_;
     }
 
+    // 깊이별 빔을 얕은 쪽부터 한 번 훑는다. beam은 beam_depth + 1개의 큐를 가진다.
+    // on_expand(now_state, next_state, action)은 전개한 자식을 빔에 넣기 직전에 불린다.
+    // stop_token으로 중단되면 false를 반환한다.
+    template<typename Beams, typename OnExpand>
+    bool sweepBeams(Beams &beam, const int beam_width, const int beam_depth, OnExpand &&on_expand,
+                    const std::stop_token &stop_token = {}) {
+        for (int t = 0; t < beam_depth; t++) {
+            auto &now_beam = beam[t];
+            auto &next_beam = beam[t + 1];
+            for (int i = 0; i < beam_width; i++) {
+                if (stop_token.stop_requested()) { return false; }
+                if (now_beam.empty())
+                    break;
+
+                State now_state = now_beam.top();
+                if (now_state.isDone()) { break; }
+                now_beam.pop();
+                int legal_actions[4];
+                const int legal_action_n = now_state.legalActions(legal_actions);
+                for (int a = 0; a < legal_action_n; a++) {
+                    const int action = legal_actions[a];
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    on_expand(now_state, next_state, action);
+                    next_beam.push(next_state);
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename Beams>
+    bool sweepBeams(Beams &beam, const int beam_width, const int beam_depth,
+                    const std::stop_token &stop_token = {}) {
+        return sweepBeams(beam, beam_width, beam_depth, [](const State &, State &, int) {
+        }, stop_token);
+    }
+
+    // 가장 깊은 빔의 최선 상태. 루트만 남은 beam[0]은 첫 행동이 없으므로 보지 않는다. 없으면 nullptr
+    template<typename Beams>
+    const State *deepestBestState(const Beams &beam, const int beam_depth) {
+        for (int t = beam_depth; t >= 1; t--) {
+            if (!beam[t].empty()) {
+                return &beam[t].top();
+            }
+        }
+        return nullptr;
+    }
+
     int chokudaiSearchAction(const State &state, const int beam_width, const int beam_depth,
                              const int beam_number) {
-        auto beam = std::vector<std::priority_queue<State> >(beam_depth);
-        for (int i = 0; i < beam_depth; i++) {
-            beam[i] = std::priority_queue<State>();
+        auto beam = std::vector<std::priority_queue<State> >(beam_depth + 1);
+        beam[0].push(state);
+        for (int cnt = 0; cnt < beam_number; cnt++) {
+            sweepBeams(beam, beam_width, beam_depth);
         }
+        const State *best_state = deepestBestState(beam, beam_depth);
+        return best_state == nullptr ? -1 : best_state->first_action_;
+    }
+
+    // chokudaiSearchAction을 코루틴으로 만든 것. 빔을 한 번 훑을 때마다 스케줄러에 양보한다.
+    SessionScheduler::Task<int> chokudaiSearchActionCoroutine(const State state, const int beam_width,
+                                                              const int beam_depth, const int beam_number) {
+        auto beam = std::vector<std::priority_queue<State> >(beam_depth + 1);
         beam[0].push(state);
+        for (int cnt = 0; cnt < beam_number; cnt++) {
+            sweepBeams(beam, beam_width, beam_depth);
+            co_await SessionScheduler::yield();
+        }
+        const State *best_state = deepestBestState(beam, beam_depth);
+        co_return best_state == nullptr ? -1 : best_state->first_action_;
+    }
+
+    // 빔에 남아있는 상태 중 consensus_ratio 이상이 같은 첫 행동을 가지면 남은 반복을 건너뛴다.
+    // 1.0이면 모든 상태가 같은 경우에만 멈추므로 결과는 바뀌지 않는다. (자손도 모두 같은 첫 행동을 가진다)
+    int chokudaiSearchActionWithConsensus(const State &state, const int beam_width, const int beam_depth,
+                                          const int beam_number, const double consensus_ratio = 1.0) {
+        auto beam = std::vector<std::priority_queue<State> >(beam_depth + 1);
+        beam[0].push(state);
+        // 깊이 1 이상의 빔에 남아있는 상태의 첫 행동별 개수
+        int votes[4] = {};
+        int alive_count = 0;
         for (int cnt = 0; cnt < beam_number; cnt++) {
             for (int t = 0; t < beam_depth; t++) {
                 auto &now_beam = beam[t];
@@ -293,6 +474,10 @@ namespace ChokudaiSearch {
                     State now_state = now_beam.top();
                     if (now_state.isDone()) { break; }
                     now_beam.pop();
+                    if (t > 0) {
+                        votes[now_state.first_action_]--;
+                        alive_count--;
+                    }
                     auto legal_actions = now_state.legalActions();
                     for (const auto &action: legal_actions) {
                         State next_state = now_state;
@@ -300,12 +485,16 @@ namespace ChokudaiSearch {
                         next_state.evaluateScore();
                         if (t == 0)
                             next_state.first_action_ = action;
+                        votes[next_state.first_action_]++;
+                        alive_count++;
                         next_beam.push(next_state);
                     }
                 }
             }
+            const int max_vote = *std::max_element(votes, votes + 4);
+            if (alive_count > 0 && max_vote >= consensus_ratio * alive_count) { break; }
         }
-        for (int t = beam_depth; t >= 0; t--) {
+        for (int t = beam_depth; t >= 1; t--) {
             const auto &now_beam = beam[t];
             if (!now_beam.empty()) {
                 return now_beam.top().first_action_;
@@ -314,6 +503,306 @@ namespace ChokudaiSearch {
         return -1;
     }
 
+    // tree에 남아있는 이전 턴의 깊이별 빔부터 탐색을 이어간다. 호출한 쪽은 행동을 실행한 뒤 tree.promote()를 호출한다.
+    int chokudaiSearchAction(const State &state, const int beam_width, const int beam_depth,
+                             const int beam_number, ChokudaiTree &tree) {
+        bool is_reused = false;
+        for (const auto &queue: tree.beam_) {
+            if (!queue.empty()) {
+                is_reused = true;
+                break;
+            }
+        }
+        if (!is_reused) {
+            tree.clear();
+        }
+        tree.beam_.resize(beam_depth + 1);
+        if (!is_reused) {
+            tree.beam_[0].push(state);
+        }
+
+        auto &beam = tree.beam_;
+        for (int cnt = 0; cnt < beam_number; cnt++) {
+            sweepBeams(beam, beam_width, beam_depth,
+                       [&tree](const State &now_state, State &next_state, const int action) {
+                           next_state.node_id_ = tree.addNode(now_state.node_id_, action);
+                       });
+        }
+        const State *best_state = deepestBestState(beam, beam_depth);
+        return best_state == nullptr ? -1 : best_state->first_action_;
+    }
+
+    void testAiScoreWithTreeReuse(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            ChokudaiTree tree;
+            while (!state.isDone()) {
+                int action = chokudaiSearchAction(state, 1, END_TURN, 2, tree);
+                state.advance(action);
+                tree.promote(action);
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+
+    // 아레나에서 메모리를 받는 빔. 미리 capacity만큼 잡아 두므로 탐색 중에 다시 할당하지 않는다.
+    using ArenaBeam = std::priority_queue<State, std::vector<State, Arena::ArenaAllocator<State> > >;
+
+    ArenaBeam makeArenaBeam(Arena::MonotonicArena &arena, const size_t capacity) {
+        std::vector<State, Arena::ArenaAllocator<State> > container{Arena::ArenaAllocator<State>(arena)};
+        container.reserve(capacity);
+        return ArenaBeam(std::less<State>(), std::move(container));
+    }
+
+    // chokudaiSearchAction과 같지만 깊이별 빔을 모두 arena에서 할당한다. 호출할 때마다 arena를 비우고 다시 쓴다.
+    int chokudaiSearchAction(const State &state, const int beam_width, const int beam_depth,
+                             const int beam_number, Arena::MonotonicArena &arena) {
+        arena.reset();
+        std::vector<ArenaBeam, Arena::ArenaAllocator<ArenaBeam> > beam{Arena::ArenaAllocator<ArenaBeam>(arena)};
+        beam.reserve(beam_depth + 1);
+        beam.push_back(makeArenaBeam(arena, 1));
+        for (int t = 1; t <= beam_depth; t++) {
+            // 깊이마다 beam_number번, 한 번에 beam_width개의 상태에서 최대 4개씩 들어온다.
+            beam.push_back(makeArenaBeam(arena, (size_t) beam_number * beam_width * 4));
+        }
+        beam[0].push(state);
+        for (int cnt = 0; cnt < beam_number; cnt++) {
+            sweepBeams(beam, beam_width, beam_depth);
+        }
+        const State *best_state = deepestBestState(beam, beam_depth);
+        return best_state == nullptr ? -1 : best_state->first_action_;
+    }
+
+    void testAiScoreWithArena(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        Arena::MonotonicArena arena;
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                state.advance(chokudaiSearchAction(state, 1, END_TURN, 2, arena));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+        std::cout << "Arena:\t" << arena.peakBytesUsed() << " / " << arena.bytesReserved() << " bytes\n";
+    }
+
+    // 최솟값과 최댓값을 모두 O(log n)에 꺼낼 수 있는 min-max 힙.
+    // 짝수 층은 자기 서브트리의 최솟값, 홀수 층은 최댓값을 가진다.
+    template<typename T>
+    class MinMaxHeap {
+    private:
+        std::vector<T> data_;
+
+        static bool isMinLevel(const size_t i) {
+            return std::bit_width(i + 1) % 2 == 1;
+        }
+
+        // is_min 층 기준으로 a가 b보다 위에 있어야 하는지
+        static bool isHigher(const T &a, const T &b, const bool is_min) {
+            return is_min ? a < b : b < a;
+        }
+
+        void pushUpLevel(size_t i, const bool is_min) {
+            while (i > 2) {
+                const size_t grandparent = ((i - 1) / 2 - 1) / 2;
+                if (!isHigher(this->data_[i], this->data_[grandparent], is_min)) { break; }
+                std::swap(this->data_[i], this->data_[grandparent]);
+                i = grandparent;
+            }
+        }
+
+        void pushUp(const size_t i) {
+            if (i == 0) { return; }
+            const size_t parent = (i - 1) / 2;
+            const bool is_min = isMinLevel(i);
+            if (isHigher(this->data_[parent], this->data_[i], is_min)) {
+                std::swap(this->data_[i], this->data_[parent]);
+                this->pushUpLevel(parent, !is_min);
+            } else {
+                this->pushUpLevel(i, is_min);
+            }
+        }
+
+        void trickleDown(size_t i) {
+            const bool is_min = isMinLevel(i);
+            const size_t n = this->data_.size();
+            while (2 * i + 1 < n) {
+                // 자식과 손자 중 가장 위에 있어야 하는 것
+                size_t m = 2 * i + 1;
+                const size_t candidates[5] = {2 * i + 2, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6};
+                for (const auto c: candidates) {
+                    if (c < n && isHigher(this->data_[c], this->data_[m], is_min)) { m = c; }
+                }
+                if (!isHigher(this->data_[m], this->data_[i], is_min)) { return; }
+                std::swap(this->data_[m], this->data_[i]);
+                if (m <= 2 * i + 2) { return; }
+                const size_t parent = (m - 1) / 2;
+                if (isHigher(this->data_[parent], this->data_[m], is_min)) {
+                    std::swap(this->data_[m], this->data_[parent]);
+                }
+                i = m;
+            }
+        }
+
+        size_t maxIndex() const {
+            if (this->data_.size() <= 2) { return this->data_.size() - 1; }
+            return this->data_[1] < this->data_[2] ? 2 : 1;
+        }
+
+        void erase(const size_t i) {
+            this->data_[i] = std::move(this->data_.back());
+            this->data_.pop_back();
+            if (i < this->data_.size()) {
+                this->trickleDown(i);
+            }
+        }
+
+    public:
+        void reserve(const size_t capacity) {
+            this->data_.reserve(capacity);
+        }
+
+        bool empty() const {
+            return this->data_.empty();
+        }
+
+        size_t size() const {
+            return this->data_.size();
+        }
+
+        const T &min() const {
+            return this->data_[0];
+        }
+
+        const T &max() const {
+            return this->data_[this->maxIndex()];
+        }
+
+        void push(const T &value) {
+            this->data_.push_back(value);
+            this->pushUp(this->data_.size() - 1);
+        }
+
+        void popMin() {
+            this->erase(0);
+        }
+
+        void popMax() {
+            this->erase(this->maxIndex());
+        }
+
+        // capacity개가 차 있으면 가장 나쁜 것과 비교해 더 좋을 때만 바꿔 넣는다. 하나를 버렸으면 true
+        bool pushBounded(const T &value, const size_t capacity) {
+            if (this->data_.size() < capacity) {
+                this->push(value);
+                return false;
+            }
+            if (this->data_[0] < value) {
+                this->data_[0] = value;
+                this->trickleDown(0);
+            }
+            return true;
+        }
+    };
+
+    // chokudaiSearchAction과 같지만 깊이별 빔이 memory_cap 바이트를 넘지 않도록 가장 나쁜 상태부터 버린다.
+    // 깊이마다 memory_cap을 똑같이 나눠 갖는다. 버린 상태 수를 evicted_count에 더한다.
+    // 깊이마다 상태를 하나도 둘 수 없는 memory_cap이면 std::invalid_argument를 던진다.
+    int chokudaiSearchActionWithMemoryCap(const State &state, const int beam_width, const int beam_depth,
+                                          const int beam_number, const size_t memory_cap,
+                                          int64_t &evicted_count) {
+        // beam_width보다 작아져도 memory_cap을 넘지 않도록 그대로 쓴다.
+        const size_t capacity = memory_cap / sizeof(State) / (beam_depth + 1);
+        if (capacity == 0) {
+            throw std::invalid_argument("memory_cap must hold at least one state per depth");
+        }
+        auto beam = std::vector<MinMaxHeap<State> >(beam_depth + 1);
+        for (auto &heap: beam) {
+            heap.reserve(capacity);
+        }
+        beam[0].push(state);
+        for (int cnt = 0; cnt < beam_number; cnt++) {
+            for (int t = 0; t < beam_depth; t++) {
+                auto &now_beam = beam[t];
+                auto &next_beam = beam[t + 1];
+                for (int i = 0; i < beam_width; i++) {
+                    if (now_beam.empty())
+                        break;
+
+                    State now_state = now_beam.max();
+                    if (now_state.isDone()) { break; }
+                    now_beam.popMax();
+                    auto legal_actions = now_state.legalActions();
+                    for (const auto &action: legal_actions) {
+                        State next_state = now_state;
+                        next_state.advance(action);
+                        next_state.evaluateScore();
+                        if (t == 0)
+                            next_state.first_action_ = action;
+                        if (next_beam.pushBounded(next_state, capacity)) {
+                            evicted_count++;
+                        }
+                    }
+                }
+            }
+        }
+        for (int t = beam_depth; t >= 1; t--) {
+            const auto &now_beam = beam[t];
+            if (!now_beam.empty()) {
+                return now_beam.max().first_action_;
+            }
+        }
+        return -1;
+    }
+
+    void testAiScoreWithMemoryCap(const int game_number, const size_t memory_cap) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        int64_t evicted_count = 0;
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                state.advance(chokudaiSearchActionWithMemoryCap(state, 1, END_TURN, 2, memory_cap, evicted_count));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+        std::cout << "Evicted:\t" << evicted_count << "\n";
+    }
+
+    // chokudaiSearchAction을 stop_token으로 언제든 멈출 수 있게 한 것. beam_number번 반복하거나 중단될 때까지
+    // 한 번 훑을 때마다 가장 깊은 빔의 최선을 알린다.
+    void chokudaiSearchActionAsync(const State &state, const int beam_width, const int beam_depth,
+                                   const int beam_number, const std::stop_token &stop_token,
+                                   AsyncSearch::SearchTask<AsyncSearch::ActionScore> &task) {
+        auto beam = std::vector<std::priority_queue<State> >(beam_depth + 1);
+        beam[0].push(state);
+        for (int cnt = 0; cnt < beam_number; cnt++) {
+            if (!sweepBeams(beam, beam_width, beam_depth, stop_token)) { return; }
+            if (const State *best_state = deepestBestState(beam, beam_depth); best_state != nullptr) {
+                task.publish(AsyncSearch::ActionScore{best_state->first_action_, best_state->evaluated_score_});
+            }
+        }
+    }
+
+    void startChokudaiSearch(AsyncSearch::SearchTask<AsyncSearch::ActionScore> &task, const State &state,
+                             const int beam_width, const int beam_depth, const int beam_number) {
+        task.start([state, beam_width, beam_depth, beam_number](const std::stop_token &stop_token, auto &task) {
+            chokudaiSearchActionAsync(state, beam_width, beam_depth, beam_number, stop_token, task);
+        });
+    }
+
     void testAiScore(const int game_number) {
         std::mt19937 mt_for_construct(0);
         double score_mean{0};
@@ -0,0 +1,332 @@
+//
+// Created by eu on 2026-10-19.
+//
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <iostream>
+#include <vector>
+#include <sstream>
+#include <queue>
+#include <chrono>
+#include <algorithm>
+
+namespace CopyOnWriteBoard {
+    using ScoreType = int64_t;
+    constexpr const ScoreType INF = 1000000000LL;
+
+    struct Coord {
+        int y_;
+        int x_;
+
+        Coord(const int y = 0, const int x = 0): y_(y), x_(x) {
+        }
+    };
+
+    constexpr const int H{30};
+    constexpr const int W{30};
+    constexpr int END_TURN{100};
+
+    constexpr const int CELL_N{H * W};
+    // 참조 횟수와 칸 점수를 합쳐 캐시 라인 하나에 맞춘다.
+    constexpr const int CHUNK_CELL_N{60};
+    constexpr const int CHUNK_N{(CELL_N + CHUNK_CELL_N - 1) / CHUNK_CELL_N};
+
+    class TimeKeeper {
+    private:
+        std::chrono::time_point<std::chrono::high_resolution_clock> start_time_;
+        int64_t time_threshold_;
+
+    public:
+        // 시간 제한을 밀리초 단위로 지정해서 인스턴스르 생성
+        TimeKeeper(const int64_t &time_threshold): start_time_(std::chrono::high_resolution_clock::now()),
+                                                   time_threshold_(time_threshold) {
+        }
+
+        bool isTimeOver() const {
+            using std::chrono::duration_cast;
+            using std::chrono::milliseconds;
+            auto diff = std::chrono::high_resolution_clock::now() - this->start_time_;
+            return duration_cast<milliseconds>(diff).count() >= time_threshold_;
+        }
+    };
+
+    // 게임판의 한 조각. 여러 상태가 같은 조각을 공유하고, 바꿀 때만 복제한다.
+    struct alignas(64) Chunk {
+        int32_t ref_count_;
+        int8_t points_[CHUNK_CELL_N];
+    };
+
+    static_assert(sizeof(Chunk) == 64, "chunk must fit in one cache line");
+
+    // 다 쓴 조각을 모아 두었다가 다시 쓴다. 참조 횟수가 원자적이지 않으므로 조각은 한 스레드 안에서만 공유한다.
+    class ChunkPool {
+    private:
+        std::vector<Chunk *> free_chunks_;
+
+    public:
+        ChunkPool() = default;
+        ChunkPool(const ChunkPool &) = delete;
+        ChunkPool &operator=(const ChunkPool &) = delete;
+
+        ~ChunkPool() {
+            for (auto *chunk: this->free_chunks_) {
+                delete chunk;
+            }
+        }
+
+        Chunk *acquire() {
+            if (this->free_chunks_.empty()) {
+                return new Chunk();
+            }
+            auto *chunk = this->free_chunks_.back();
+            this->free_chunks_.pop_back();
+            return chunk;
+        }
+
+        void release(Chunk *chunk) {
+            this->free_chunks_.push_back(chunk);
+        }
+    };
+
+    thread_local ChunkPool chunk_pool;
+
+    // CHUNK_CELL_N칸씩 나눈 게임판. 복사하면 조각 포인터만 복사하고, set()으로 바꿀 때 그 조각만 복제한다.
+    class ChunkedBoard {
+    private:
+        Chunk *chunks_[CHUNK_N] = {};
+
+        void retainAll() const {
+            for (auto *chunk: this->chunks_) {
+                chunk->ref_count_++;
+            }
+        }
+
+        void releaseAll() {
+            for (auto *chunk: this->chunks_) {
+                if (chunk != nullptr && --chunk->ref_count_ == 0) {
+                    chunk_pool.release(chunk);
+                }
+            }
+        }
+
+    public:
+        ChunkedBoard() {
+            for (auto &chunk: this->chunks_) {
+                chunk = chunk_pool.acquire();
+                chunk->ref_count_ = 1;
+                std::memset(chunk->points_, 0, sizeof(chunk->points_));
+            }
+        }
+
+        ChunkedBoard(const ChunkedBoard &other) {
+            std::memcpy(this->chunks_, other.chunks_, sizeof(this->chunks_));
+            this->retainAll();
+        }
+
+        ChunkedBoard(ChunkedBoard &&other) noexcept {
+            std::memcpy(this->chunks_, other.chunks_, sizeof(this->chunks_));
+            std::memset(other.chunks_, 0, sizeof(other.chunks_));
+        }
+
+        ChunkedBoard &operator=(ChunkedBoard &&other) noexcept {
+            if (this != &other) {
+                this->releaseAll();
+                std::memcpy(this->chunks_, other.chunks_, sizeof(this->chunks_));
+                std::memset(other.chunks_, 0, sizeof(other.chunks_));
+            }
+            return *this;
+        }
+
+        ChunkedBoard &operator=(const ChunkedBoard &other) {
+            if (this != &other) {
+                other.retainAll();
+                this->releaseAll();
+                std::memcpy(this->chunks_, other.chunks_, sizeof(this->chunks_));
+            }
+            return *this;
+        }
+
+        ~ChunkedBoard() {
+            this->releaseAll();
+        }
+
+        int get(const int cell) const {
+            return this->chunks_[cell / CHUNK_CELL_N]->points_[cell % CHUNK_CELL_N];
+        }
+
+        void set(const int cell, const int point) {
+            auto *&chunk = this->chunks_[cell / CHUNK_CELL_N];
+            if (chunk->ref_count_ > 1) {
+                auto *clone = chunk_pool.acquire();
+                std::memcpy(clone->points_, chunk->points_, sizeof(clone->points_));
+                clone->ref_count_ = 1;
+                chunk->ref_count_--;
+                chunk = clone;
+            }
+            chunk->points_[cell % CHUNK_CELL_N] = (int8_t) point;
+        }
+    };
+
+    class State {
+    private:
+        ChunkedBoard points_;
+        int turn_{0};
+
+        static constexpr const int dx[4] = {1, -1, 0, 0};
+        static constexpr const int dy[4] = {0, 0, 1, -1};
+
+    public:
+        // 탐색 트리의 루트 노드에서 처음으로 선택한 행동
+        int first_action_{-1};
+
+        friend bool operator<(const State &maze_1, const State &maze_2) {
+            return maze_1.evaluated_score_ < maze_2.evaluated_score_;
+        }
+
+    public:
+        Coord character_ = Coord(0, 0);
+        int game_score_ = 0;
+
+        State() = default;
+
+        State(const int seed) {
+            auto mt_for_construct = std::mt19937(seed);
+            this->character_.y_ = mt_for_construct() % H;
+            this->character_.x_ = mt_for_construct() % W;
+
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    if (y == character_.y_ && x == character_.x_) {
+                        continue;
+                    }
+                    this->points_.set(y * W + x, mt_for_construct() % 10);
+                }
+            }
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        int point(const int y, const int x) const {
+            return this->points_.get(y * W + x);
+        }
+
+        void advance(const int action) {
+            this->character_.x_ += dx[action];
+            this->character_.y_ += dy[action];
+            const int cell = this->character_.y_ * W + this->character_.x_;
+            const int point = this->points_.get(cell);
+            if (point > 0) {
+                this->game_score_ += point;
+                this->points_.set(cell, 0);
+            }
+            this->turn_++;
+        }
+
+        // 현재 상황에서 플레이어가 가능한 행동을 모두 획득한다.
+        std::vector<int> legalActions() const {
+            std::vector<int> actions;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions.emplace_back(action);
+                }
+            }
+            return actions;
+        }
+
+        // 현재 게임 상황을 문자열로 만든다.
+        std::string toString() const {
+            std::stringstream ss;
+            ss << "turn:\t" << this->turn_ << "\n";
+            ss << "score:\t" << this->game_score_ << "\n";
+            for (int h = 0; h < H; h++) {
+                for (int w = 0; w < W; w++) {
+                    if (this->character_.y_ == h && this->character_.x_ == w) {
+                        ss << '@';
+                    } else if (this->point(h, w) > 0) {
+                        ss << this->point(h, w);
+                    } else {
+                        ss << ".";
+                    }
+                }
+                ss << "\n";
+            }
+            return ss.str();
+        }
+
+    public:
+        // 탐색을 통해 확인한 점수
+        ScoreType evaluated_score_ = 0;
+        // 탐색용으로 게임판을 평가
+        void evaluateScore() {
+            // 간단히 우선 기록 점수를 그대로 게임판의 평가로 사용
+            this->evaluated_score_ = this->game_score_;
+        }
+    };
+
+    // 자식 상태는 부모와 한 칸만 다르므로, 복사할 때 조각 포인터만 복사하고 점수를 얻은 칸의 조각 하나만 복제한다.
+    int beamSearchActionWithTimeThreshold(const State &state, const int beam_width, const int64_t time_threshold) {
+        auto time_keeper = TimeKeeper(time_threshold);
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            std::priority_queue<State> next_beam;
+            for (int i = 0; i < beam_width; ++i) {
+                if (time_keeper.isTimeOver()) {
+                    return best_state.first_action_;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = std::move(next_beam);
+            best_state = now_beam.top();
+
+            if (best_state.isDone()) { break; }
+        }
+        return best_state.first_action_;
+    }
+
+    void playGame(const int seed) {
+        auto state = State(seed);
+        std::cout << state.toString() << "\n";
+        while (!state.isDone()) {
+            state.advance(beamSearchActionWithTimeThreshold(state, 5, 10));
+            std::cout << state.toString() << "\n";
+        }
+    }
+
+    void testAiScore(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                state.advance(beamSearchActionWithTimeThreshold(state, 5, 10));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+}
@@ -8,6 +8,24 @@
 #include <sstream>
 #include <queue>
 #include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include "AsyncSearch.h"
+#include "ThreadPool.h"
+
+// target_clones는 ifunc가 있는 ELF의 GCC/Clang에서만 쓸 수 있고 avx2는 x86에만 있다.
+// 그 밖의 툴체인에서는 기본 빌드 하나만 만든다.
+#if defined(__GNUC__) && defined(__ELF__) && (defined(__x86_64__) || defined(__i386__))
+#define HILL_CLIMB_AVX2_CLONES [[gnu::target_clones("avx2", "default")]]
+#else
+#define HILL_CLIMB_AVX2_CLONES
+#endif
 
 namespace HillClimb
 {
@@ -29,6 +47,40 @@ namespace HillClimb
     constexpr const int W{5};
     constexpr int END_TURN{5};
     constexpr int CHARACTER_N{3};
+    // getScores()가 한 번에 계산하는 배치 수
+    constexpr int LANE_N{16};
+    constexpr int CELL_N{H * W};
+
+    static_assert(CELL_N < 32, "cells are tracked in a 32-bit mask");
+
+    // 칸 비트마스크에서 각 방향으로 이동할 수 있는 칸
+    constexpr uint32_t cellMask(const int y_begin, const int y_end, const int x_begin, const int x_end)
+    {
+        uint32_t mask = 0;
+        for (int y = y_begin; y < y_end; y++)
+        {
+            for (int x = x_begin; x < x_end; x++)
+            {
+                mask |= 1u << (y * W + x);
+            }
+        }
+        return mask;
+    }
+
+    constexpr const uint32_t CAN_MOVE_RIGHT{cellMask(0, H, 0, W - 1)};
+    constexpr const uint32_t CAN_MOVE_LEFT{cellMask(0, H, 1, W)};
+    constexpr const uint32_t CAN_MOVE_DOWN{cellMask(0, H - 1, 0, W)};
+    // 점수(1~9)를 비트 단위로 나눠 저장하는 비트 평면 수
+    constexpr const int PLANE_N{4};
+
+    // 비트 평면에서 cell(한 비트만 켜진 마스크) 위치의 점수를 꺼낸다.
+    inline int32_t planeValue(const uint32_t (*planes)[LANE_N], const int lane, const uint32_t cell)
+    {
+        return static_cast<int32_t>((planes[0][lane] & cell) != 0) |
+               static_cast<int32_t>((planes[1][lane] & cell) != 0) << 1 |
+               static_cast<int32_t>((planes[2][lane] & cell) != 0) << 2 |
+               static_cast<int32_t>((planes[3][lane] & cell) != 0) << 3;
+    }
 
     class TimeKeeper
     {
@@ -138,6 +190,106 @@ namespace HillClimb
             return tmp_state.game_score_;
         }
 
+        // 같은 게임판에 대한 여러 배치의 getScore()를 LANE_N개씩 동시에 계산한다.
+        // 레인마다 게임판을 복사하지 않고 캐릭터 위치와 점수를 칸 비트마스크로 나타내므로
+        // 이웃 점수를 모으는 것도 모든 레인에서 같은 시프트와 AND 연산이 되어 벡터화된다.
+        // AVX2가 있으면 8레인 정수 연산으로 실행되도록 함수를 두 벌 생성한다. (지원하는 툴체인에서만)
+        HILL_CLIMB_AVX2_CLONES
+        void getScores(const Coord (*placements)[CHARACTER_N], const int placement_n, ScoreType* scores) const
+        {
+            // 점수의 k번째 비트가 1인 칸의 비트마스크
+            uint32_t board_planes[PLANE_N] = {};
+            for (int cell = 0; cell < CELL_N; cell++)
+            {
+                for (int k = 0; k < PLANE_N; k++)
+                {
+                    board_planes[k] |= static_cast<uint32_t>(this->points_[cell / W][cell % W] >> k & 1) << cell;
+                }
+            }
+
+            for (int begin = 0; begin < placement_n; begin += LANE_N)
+            {
+                uint32_t planes[PLANE_N][LANE_N];
+                uint32_t positions[CHARACTER_N][LANE_N];
+                int32_t lane_scores[LANE_N];
+                for (int lane = 0; lane < LANE_N; lane++)
+                {
+                    // 남는 레인은 첫 배치로 채우고 결과는 버린다.
+                    const auto& placement = placements[begin + lane < placement_n ? begin + lane : begin];
+                    uint32_t start_cells = 0;
+                    for (int c = 0; c < CHARACTER_N; c++)
+                    {
+                        positions[c][lane] = 1u << (placement[c].y_ * W + placement[c].x_);
+                        start_cells |= positions[c][lane];
+                    }
+                    // 캐릭터 위치에 있는 점수를 삭제한다.
+                    for (int k = 0; k < PLANE_N; k++)
+                    {
+                        planes[k][lane] = board_planes[k] & ~start_cells;
+                    }
+                    lane_scores[lane] = this->game_score_;
+                }
+
+                for (int turn = this->turn_; turn < END_TURN; turn++)
+                {
+                    for (int c = 0; c < CHARACTER_N; c++)
+                    {
+                        for (int lane = 0; lane < LANE_N; lane++)
+                        {
+                            const uint32_t position = positions[c][lane];
+                            // movePlayer와 같은 행동 순서 (오른쪽, 왼쪽, 아래, 위)
+                            const uint32_t next[4] = {
+                                (position & CAN_MOVE_RIGHT) << 1,
+                                (position & CAN_MOVE_LEFT) >> 1,
+                                (position & CAN_MOVE_DOWN) << W,
+                                position >> W,
+                            };
+                            // 처음 나온 최댓값을 고른다. 판 밖은 -1로 둔다.
+                            int32_t best_point = -2;
+                            uint32_t best_position = position;
+                            for (int action = 0; action < 4; action++)
+                            {
+                                const int32_t point = next[action] != 0
+                                                          ? planeValue(planes, lane, next[action])
+                                                          : -1;
+                                const bool is_better = point > best_point;
+                                best_point = is_better ? point : best_point;
+                                best_position = is_better ? next[action] : best_position;
+                            }
+                            positions[c][lane] = best_position;
+                        }
+                    }
+                    for (int c = 0; c < CHARACTER_N; c++)
+                    {
+                        for (int lane = 0; lane < LANE_N; lane++)
+                        {
+                            const uint32_t position = positions[c][lane];
+                            lane_scores[lane] += planeValue(planes, lane, position);
+                            planes[0][lane] &= ~position;
+                            planes[1][lane] &= ~position;
+                            planes[2][lane] &= ~position;
+                            planes[3][lane] &= ~position;
+                        }
+                    }
+                }
+
+                for (int lane = 0; lane < LANE_N && begin + lane < placement_n; lane++)
+                {
+                    scores[begin + lane] = lane_scores[lane];
+                }
+            }
+        }
+
+        const Coord& character(const int character_id) const
+        {
+            return this->characters_[character_id];
+        }
+
+        int point(const int y, const int x) const
+        {
+            return this->points_[y][x];
+        }
+
         void movePlayer(const int character_id)
         {
             Coord& character = this->characters_[character_id];
@@ -176,20 +328,31 @@ namespace HillClimb
             ++this->turn_;
         }
 
-        void init()
+        // 여러 스레드에서 동시에 탐색할 때는 탐색마다 따로 가진 mt를 넘긴다.
+        void init(std::mt19937& mt)
         {
             for (auto& character : this->characters_)
             {
-                character.y_ = mt_for_action() % H;
-                character.x_ = mt_for_action() % W;
+                character.y_ = mt() % H;
+                character.x_ = mt() % W;
             }
         }
 
+        void init()
+        {
+            this->init(mt_for_action);
+        }
+
+        void transition(std::mt19937& mt)
+        {
+            auto& character = this->characters_[mt() % CHARACTER_N];
+            character.y_ = mt() % H;
+            character.x_ = mt() % W;
+        }
+
         void transition()
         {
-            auto& character = this->characters_[mt_for_action() % CHARACTER_N];
-            character.y_ = mt_for_action() % H;
-            character.x_ = mt_for_action() % W;
+            this->transition(mt_for_action);
         }
     };
 
@@ -228,6 +391,650 @@ namespace HillClimb
         return now_state;
     }
 
+    // 무작위 이웃을 LANE_N개씩 만들어 getScores()로 한 번에 평가하고 가장 좋은 이웃으로 이동한다.
+    State hillClimbByNeighbourhood(const State& state, int number)
+    {
+        State now_state = state;
+        now_state.init();
+        ScoreType best_score = now_state.getScore();
+
+        Coord placements[LANE_N][CHARACTER_N];
+        ScoreType scores[LANE_N];
+        for (int i = 0; i < number; i += LANE_N)
+        {
+            for (int lane = 0; lane < LANE_N; ++lane)
+            {
+                auto next_state = now_state;
+                next_state.transition();
+                for (int c = 0; c < CHARACTER_N; ++c)
+                {
+                    placements[lane][c] = next_state.character(c);
+                }
+            }
+            now_state.getScores(placements, LANE_N, scores);
+
+            int best_lane = -1;
+            for (int lane = 0; lane < LANE_N; ++lane)
+            {
+                if (scores[lane] > best_score)
+                {
+                    best_score = scores[lane];
+                    best_lane = lane;
+                }
+            }
+            if (best_lane != -1)
+            {
+                for (int c = 0; c < CHARACTER_N; ++c)
+                {
+                    now_state.setCharacter(c, placements[best_lane][c].y_, placements[best_lane][c].x_);
+                }
+            }
+        }
+        return now_state;
+    }
+
+    // 무작위 배치 N개의 점수를 getScore()와 getScores()로 각각 구해 속도와 결과를 비교한다.
+    void testGetScores(const int placement_number)
+    {
+        using std::chrono::duration;
+        using std::chrono::high_resolution_clock;
+
+        auto state = State(0);
+        std::vector<State> placements;
+        auto coords = std::make_unique<Coord[][CHARACTER_N]>(placement_number);
+        for (int i = 0; i < placement_number; ++i)
+        {
+            auto placement = state;
+            placement.init();
+            for (int c = 0; c < CHARACTER_N; ++c)
+            {
+                coords[i][c] = placement.character(c);
+            }
+            placements.emplace_back(placement);
+        }
+
+        auto start_time = high_resolution_clock::now();
+        std::vector<ScoreType> scalar_scores;
+        for (const auto& placement : placements)
+        {
+            scalar_scores.emplace_back(placement.getScore());
+        }
+        const double scalar_seconds = duration<double>(high_resolution_clock::now() - start_time).count();
+
+        start_time = high_resolution_clock::now();
+        std::vector<ScoreType> batch_scores(placement_number);
+        state.getScores(coords.get(), placement_number, batch_scores.data());
+        const double batch_seconds = duration<double>(high_resolution_clock::now() - start_time).count();
+
+        int mismatch{0};
+        for (int i = 0; i < placement_number; ++i)
+        {
+            if (scalar_scores[i] != batch_scores[i])
+            {
+                mismatch++;
+            }
+        }
+        std::cout << "getScore placements/sec:\t" << placement_number / scalar_seconds << "\n";
+        std::cout << "getScores placements/sec:\t" << placement_number / batch_seconds << "\n";
+        std::cout << "Mismatch:\t" << mismatch << "\n";
+    }
+
+    // 아무 일도 하지 않는 작업을 task_number개 ThreadPool::parallelFor로 실행해서 초당 작업 수를 잰다.
+    // 작업이 던진 예외가 parallelFor를 호출한 쪽으로 돌아오는지도 확인한다.
+    void testThreadPool(const int64_t task_number)
+    {
+        using std::chrono::duration;
+        using std::chrono::high_resolution_clock;
+
+        std::atomic<int64_t> count{0};
+        auto start_time = high_resolution_clock::now();
+        ThreadPool::parallelFor(0, task_number, 1, [&](const int64_t)
+        {
+            count.fetch_add(1, std::memory_order_relaxed);
+        });
+        const double seconds = duration<double>(high_resolution_clock::now() - start_time).count();
+
+        bool is_rethrown = false;
+        try
+        {
+            ThreadPool::parallelFor(0, 1024, 1, [](const int64_t i)
+            {
+                if (i == 777)
+                {
+                    throw std::runtime_error("task failed");
+                }
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            is_rethrown = true;
+        }
+        std::cout << "Workers:\t" << ThreadPool::globalPool().size() << "\n";
+        std::cout << "Tasks/sec:\t" << task_number / seconds << " (" << count.load() << ")\n";
+        std::cout << "Rethrown:\t" << is_rethrown << "\n";
+    }
+
+    // 캐릭터 하나를 다른 칸으로 옮기는 이웃의 수. 이웃 m은 캐릭터 m / CELL_N을 칸 m % CELL_N으로 옮긴다.
+    constexpr const int MOVE_N{CHARACTER_N * CELL_N};
+    // 이웃을 LANE_N개씩 나눈 배치 수. 배치 하나가 병렬 작업 하나가 된다.
+    constexpr const int MOVE_BATCH_N{(MOVE_N + LANE_N - 1) / LANE_N};
+    // 캐릭터가 떠난 칸으로 다시 돌아가지 못하는 반복 수
+    constexpr const int TABU_TENURE{7};
+
+    // 매 반복 캐릭터 하나를 옮기는 이웃을 모두 평가해, 금지되지 않은 것 중 가장 좋은 이웃으로 이동한다. (더 나빠지더라도 이동)
+    // 캐릭터가 떠난 칸은 tenure번 반복하는 동안 그 캐릭터에게 금지하되, 지금까지의 최고 점수를 넘으면 허용한다.
+    // 이웃은 LANE_N개씩 getScores()로 평가하고, 배치 하나를 병렬 작업 하나로 실행한다.
+    State tabuSearch(const State& state, const int64_t time_threshold, const int tenure = TABU_TENURE)
+    {
+        auto time_keeper = TimeKeeper(time_threshold);
+        State now_state = state;
+        now_state.init();
+        State best_state = now_state;
+        ScoreType best_score = now_state.getScore();
+
+        // tabu_until[c][cell]: 이 반복이 되기 전에는 캐릭터 c를 cell로 옮기지 않는다.
+        std::vector<int64_t> tabu_until(MOVE_N, 0);
+        Coord placements[MOVE_BATCH_N * LANE_N][CHARACTER_N];
+        ScoreType scores[MOVE_BATCH_N * LANE_N];
+        for (int64_t iteration = 0; !time_keeper.isTimeOver(); iteration++)
+        {
+            ThreadPool::parallelFor(0, MOVE_BATCH_N, 1, [&](const int64_t batch)
+            {
+                const int begin = (int)batch * LANE_N;
+                const int end = std::min(MOVE_N, begin + LANE_N);
+                for (int m = begin; m < end; m++)
+                {
+                    for (int c = 0; c < CHARACTER_N; c++)
+                    {
+                        placements[m][c] = now_state.character(c);
+                    }
+                    const int cell = m % CELL_N;
+                    placements[m][m / CELL_N] = Coord(cell / W, cell % W);
+                }
+                now_state.getScores(placements + begin, end - begin, scores + begin);
+            });
+
+            int best_move = -1;
+            for (int m = 0; m < MOVE_N; m++)
+            {
+                const int character_id = m / CELL_N;
+                const auto& now_coord = now_state.character(character_id);
+                if (m % CELL_N == now_coord.y_ * W + now_coord.x_)
+                {
+                    continue;
+                }
+                const bool is_tabu = tabu_until[m] > iteration;
+                if (is_tabu && scores[m] <= best_score)
+                {
+                    continue;
+                }
+                if (best_move == -1 || scores[m] > scores[best_move])
+                {
+                    best_move = m;
+                }
+            }
+            if (best_move == -1)
+            {
+                continue;
+            }
+
+            const int character_id = best_move / CELL_N;
+            const auto& now_coord = now_state.character(character_id);
+            tabu_until[character_id * CELL_N + now_coord.y_ * W + now_coord.x_] = iteration + tenure;
+            const int next_cell = best_move % CELL_N;
+            now_state.setCharacter(character_id, next_cell / W, next_cell % W);
+            if (scores[best_move] > best_score)
+            {
+                best_score = scores[best_move];
+                best_state = now_state;
+            }
+        }
+        return best_state;
+    }
+
+    // 같은 시간 동안 tabuSearch와 hillClimb가 찾은 배치의 점수를 비교한다.
+    void testTabuSearch(const int game_number, const int64_t time_threshold)
+    {
+        std::mt19937 mt_for_construct(0);
+        double tabu_mean = 0;
+        double hill_climb_mean = 0;
+        for (int i = 0; i < game_number; ++i)
+        {
+            auto state = State(mt_for_construct());
+            tabu_mean += tabuSearch(state, time_threshold).getScore();
+
+            auto time_keeper = TimeKeeper(time_threshold);
+            State now_state = state;
+            now_state.init();
+            ScoreType best_score = now_state.getScore();
+            while (!time_keeper.isTimeOver())
+            {
+                auto next_state = now_state;
+                next_state.transition();
+                auto next_score = next_state.getScore();
+                if (next_score > best_score)
+                {
+                    best_score = next_score;
+                    now_state = next_state;
+                }
+            }
+            hill_climb_mean += best_score;
+        }
+        std::cout << "tabuSearch score:\t" << tabu_mean / game_number << "\n";
+        std::cout << "hillClimb score:\t" << hill_climb_mean / game_number << "\n";
+    }
+
+    constexpr const int TOURNAMENT_SIZE{3};
+    // 자식에게 transition()을 적용할 확률 (백분율)
+    constexpr const int MUTATION_PERCENT{30};
+
+    // 유전 알고리즘의 개체 하나. 개체군은 vector 하나에 이어 붙여 저장한다.
+    struct Individual
+    {
+        Coord characters_[CHARACTER_N];
+        ScoreType fitness_{-INF};
+    };
+
+    // 캐릭터는 서로 바꿔도 점수가 같으므로 칸 번호를 정렬해 이어 붙인 값을 배치의 키로 쓴다.
+    inline uint64_t placementKey(const Coord (&characters)[CHARACTER_N])
+    {
+        int cells[CHARACTER_N];
+        for (int c = 0; c < CHARACTER_N; c++)
+        {
+            cells[c] = characters[c].y_ * W + characters[c].x_;
+        }
+        std::sort(cells, cells + CHARACTER_N);
+        uint64_t key = 0;
+        for (const int cell : cells)
+        {
+            key = key * CELL_N + cell;
+        }
+        return key;
+    }
+
+    // 세대마다 개체군 전체의 적합도를 구한다.
+    // 이미 평가한 배치는 fitness_cache에서 가져오고, 처음 보는 배치만 모아 LANE_N개씩 getScores()로 병렬 평가한다.
+    void evaluatePopulation(const State& state, std::vector<Individual>& population,
+                            std::unordered_map<uint64_t, ScoreType>& fitness_cache, int64_t& evaluated_count)
+    {
+        std::vector<uint64_t> keys(population.size());
+        std::vector<uint64_t> new_keys;
+        auto placements = std::make_unique<Coord[][CHARACTER_N]>(population.size());
+        for (size_t i = 0; i < population.size(); i++)
+        {
+            keys[i] = placementKey(population[i].characters_);
+            // 새 키는 -INF로 자리만 잡아 두어 같은 세대의 중복도 한 번만 평가한다.
+            if (fitness_cache.try_emplace(keys[i], -INF).second)
+            {
+                std::copy(population[i].characters_, population[i].characters_ + CHARACTER_N,
+                          placements[new_keys.size()]);
+                new_keys.push_back(keys[i]);
+            }
+        }
+
+        const int64_t new_n = (int64_t)new_keys.size();
+        std::vector<ScoreType> scores(new_n);
+        ThreadPool::parallelFor(0, (new_n + LANE_N - 1) / LANE_N, 1, [&](const int64_t batch)
+        {
+            const int64_t begin = batch * LANE_N;
+            const int lane_n = (int)std::min<int64_t>(LANE_N, new_n - begin);
+            state.getScores(placements.get() + begin, lane_n, scores.data() + begin);
+        });
+        evaluated_count += new_n;
+
+        for (int64_t i = 0; i < new_n; i++)
+        {
+            fitness_cache[new_keys[i]] = scores[i];
+        }
+        for (size_t i = 0; i < population.size(); i++)
+        {
+            population[i].fitness_ = fitness_cache[keys[i]];
+        }
+    }
+
+    const Individual& tournamentSelect(const std::vector<Individual>& population)
+    {
+        const Individual* best = &population[mt_for_action() % population.size()];
+        for (int i = 1; i < TOURNAMENT_SIZE; i++)
+        {
+            const Individual* other = &population[mt_for_action() % population.size()];
+            if (other->fitness_ > best->fitness_)
+            {
+                best = other;
+            }
+        }
+        return *best;
+    }
+
+    // 토너먼트 선택, 캐릭터 좌표 단위의 균등 교차, transition()을 이용한 변이로 세대를 바꾼다.
+    // 가장 좋은 개체는 그대로 다음 세대에 남긴다.
+    State geneticAlgorithm(const State& state, const int population_n, const int64_t time_threshold,
+                           int64_t& evaluated_count)
+    {
+        auto time_keeper = TimeKeeper(time_threshold);
+        std::unordered_map<uint64_t, ScoreType> fitness_cache;
+        std::vector<Individual> population(population_n);
+        std::vector<Individual> next_population(population_n);
+        State mutant = state;
+        for (auto& individual : population)
+        {
+            mutant.init();
+            for (int c = 0; c < CHARACTER_N; c++)
+            {
+                individual.characters_[c] = mutant.character(c);
+            }
+        }
+        evaluated_count = 0;
+        evaluatePopulation(state, population, fitness_cache, evaluated_count);
+
+        auto best = *std::max_element(population.begin(), population.end(),
+                                      [](const Individual& a, const Individual& b) { return a.fitness_ < b.fitness_; });
+        while (!time_keeper.isTimeOver())
+        {
+            next_population[0] = best;
+            for (int i = 1; i < population_n; i++)
+            {
+                const auto& parent_a = tournamentSelect(population);
+                const auto& parent_b = tournamentSelect(population);
+                auto& child = next_population[i];
+                for (int c = 0; c < CHARACTER_N; c++)
+                {
+                    child.characters_[c] = (mt_for_action() & 1) ? parent_a.characters_[c] : parent_b.characters_[c];
+                }
+                if ((int)(mt_for_action() % 100) < MUTATION_PERCENT)
+                {
+                    for (int c = 0; c < CHARACTER_N; c++)
+                    {
+                        mutant.setCharacter(c, child.characters_[c].y_, child.characters_[c].x_);
+                    }
+                    mutant.transition();
+                    for (int c = 0; c < CHARACTER_N; c++)
+                    {
+                        child.characters_[c] = mutant.character(c);
+                    }
+                }
+            }
+            std::swap(population, next_population);
+            evaluatePopulation(state, population, fitness_cache, evaluated_count);
+            for (const auto& individual : population)
+            {
+                if (individual.fitness_ > best.fitness_)
+                {
+                    best = individual;
+                }
+            }
+        }
+
+        State best_state = state;
+        for (int c = 0; c < CHARACTER_N; c++)
+        {
+            best_state.setCharacter(c, best.characters_[c].y_, best.characters_[c].x_);
+        }
+        return best_state;
+    }
+
+    State geneticAlgorithm(const State& state, const int population_n, const int64_t time_threshold)
+    {
+        int64_t evaluated_count = 0;
+        return geneticAlgorithm(state, population_n, time_threshold, evaluated_count);
+    }
+
+    void testGeneticAlgorithm(const int game_number, const int population_n, const int64_t time_threshold)
+    {
+        std::mt19937 mt_for_construct(0);
+        double score_mean = 0;
+        int64_t evaluated_count_sum = 0;
+        for (int i = 0; i < game_number; ++i)
+        {
+            auto state = State(mt_for_construct());
+            int64_t evaluated_count = 0;
+            score_mean += geneticAlgorithm(state, population_n, time_threshold, evaluated_count).getScore();
+            evaluated_count_sum += evaluated_count;
+        }
+        std::cout << "Score:\t" << score_mean / game_number << "\n";
+        std::cout << "Evaluated placements:\t" << (double)evaluated_count_sum / game_number << "\n";
+    }
+
+    // 배치와 그 점수
+    using PlacementScore = std::pair<State, ScoreType>;
+
+    // 모든 배치를 빠짐없이 살펴 최적 배치를 구한다.
+    // 캐릭터는 서로 바꿔도 점수가 같으므로 칸 번호가 줄어들지 않는 조합만 본다. (같은 칸에 여러 캐릭터 허용)
+    // 칸은 캐릭터 하나가 그 칸에서 시작해 얻을 수 있는 점수의 상한이 큰 순서로 정렬해 두고,
+    // 지금까지 고른 칸의 상한 + 남은 캐릭터 수 * 다음 칸의 상한이 최고 점수 이하이면 그 뒤는 모두 건너뛴다.
+    class ExhaustiveSolver
+    {
+    private:
+        const State& state_;
+        std::vector<Coord> cells_;
+        // bounds_[i]: cells_[i]에서 시작하는 캐릭터 하나가 얻을 수 있는 점수의 상한 (내림차순)
+        std::vector<ScoreType> bounds_;
+        // 게임판 전체에서 모든 캐릭터가 얻을 수 있는 점수의 상한
+        ScoreType global_bound_{0};
+
+        std::atomic<ScoreType> best_score_{-INF};
+        std::mutex best_mutex_;
+        Coord best_placement_[CHARACTER_N];
+        std::atomic<int64_t> evaluated_count_{0};
+
+        // 한 턴에 한 칸만 얻고 END_TURN턴 안에 닿는 칸만 얻을 수 있으므로, 닿는 칸 중 상위 END_TURN개의 합을 넘지 못한다.
+        ScoreType cellBound(const int y, const int x) const
+        {
+            std::vector<int> points;
+            for (int ty = 0; ty < H; ty++)
+            {
+                for (int tx = 0; tx < W; tx++)
+                {
+                    const int distance = std::abs(ty - y) + std::abs(tx - x);
+                    if (distance >= 1 && distance <= END_TURN)
+                    {
+                        points.push_back(this->state_.point(ty, tx));
+                    }
+                }
+            }
+            const int k = std::min<int>(END_TURN, (int)points.size());
+            std::partial_sort(points.begin(), points.begin() + k, points.end(), std::greater<int>());
+            ScoreType bound = 0;
+            for (int i = 0; i < k; i++)
+            {
+                bound += points[i];
+            }
+            return bound;
+        }
+
+        void updateBest(const Coord (&placement)[CHARACTER_N], const ScoreType score)
+        {
+            if (score <= this->best_score_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(this->best_mutex_);
+            if (score > this->best_score_.load(std::memory_order_relaxed))
+            {
+                std::copy(placement, placement + CHARACTER_N, this->best_placement_);
+                this->best_score_.store(score, std::memory_order_relaxed);
+            }
+        }
+
+        ScoreType boundOf(const ScoreType prefix_bound, const int remain_n, const int i) const
+        {
+            return std::min(this->global_bound_, prefix_bound + remain_n * this->bounds_[i]);
+        }
+
+        // 마지막 캐릭터는 후보를 LANE_N개씩 모아 getScores()로 한꺼번에 평가한다.
+        void searchLast(const int begin, Coord (&prefix)[CHARACTER_N], const ScoreType prefix_bound)
+        {
+            Coord placements[LANE_N][CHARACTER_N];
+            ScoreType scores[LANE_N];
+            int lane_n = 0;
+            auto flush = [&]()
+            {
+                this->state_.getScores(placements, lane_n, scores);
+                this->evaluated_count_.fetch_add(lane_n, std::memory_order_relaxed);
+                for (int lane = 0; lane < lane_n; lane++)
+                {
+                    this->updateBest(placements[lane], scores[lane]);
+                }
+                lane_n = 0;
+            };
+            for (int i = begin; i < (int)this->cells_.size(); i++)
+            {
+                if (this->boundOf(prefix_bound, 1, i) <= this->best_score_.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+                prefix[CHARACTER_N - 1] = this->cells_[i];
+                std::copy(prefix, prefix + CHARACTER_N, placements[lane_n]);
+                if (++lane_n == LANE_N)
+                {
+                    flush();
+                }
+            }
+            if (lane_n > 0)
+            {
+                flush();
+            }
+        }
+
+        void search(const int depth, const int begin, Coord (&prefix)[CHARACTER_N], const ScoreType prefix_bound)
+        {
+            if (depth == CHARACTER_N - 1)
+            {
+                this->searchLast(begin, prefix, prefix_bound);
+                return;
+            }
+            for (int i = begin; i < (int)this->cells_.size(); i++)
+            {
+                if (this->boundOf(prefix_bound, CHARACTER_N - depth, i) <=
+                    this->best_score_.load(std::memory_order_relaxed))
+                {
+                    break;
+                }
+                prefix[depth] = this->cells_[i];
+                this->search(depth + 1, i, prefix, prefix_bound + this->bounds_[i]);
+            }
+        }
+
+    public:
+        explicit ExhaustiveSolver(const State& state): state_(state)
+        {
+            std::vector<std::pair<ScoreType, Coord>> bounded_cells;
+            std::vector<int> all_points;
+            for (int y = 0; y < H; y++)
+            {
+                for (int x = 0; x < W; x++)
+                {
+                    bounded_cells.emplace_back(this->cellBound(y, x), Coord(y, x));
+                    all_points.push_back(state.point(y, x));
+                }
+            }
+            std::stable_sort(bounded_cells.begin(), bounded_cells.end(),
+                             [](const auto& a, const auto& b) { return a.first > b.first; });
+            for (const auto& [bound, cell] : bounded_cells)
+            {
+                this->bounds_.push_back(bound);
+                this->cells_.push_back(cell);
+            }
+            const int k = std::min<int>(CHARACTER_N * END_TURN, (int)all_points.size());
+            std::partial_sort(all_points.begin(), all_points.begin() + k, all_points.end(), std::greater<int>());
+            for (int i = 0; i < k; i++)
+            {
+                this->global_bound_ += all_points[i];
+            }
+        }
+
+        // 첫 캐릭터의 칸마다 나눠 병렬로 탐색한다. 찾은 최고 점수는 모든 작업이 가지치기에 함께 쓴다.
+        PlacementScore solve()
+        {
+            ThreadPool::parallelFor(0, (int64_t)this->cells_.size(), 1, [&](const int64_t i)
+            {
+                if (this->boundOf(0, CHARACTER_N, (int)i) <= this->best_score_.load(std::memory_order_relaxed))
+                {
+                    return;
+                }
+                Coord prefix[CHARACTER_N];
+                prefix[0] = this->cells_[i];
+                this->search(1, (int)i, prefix, this->bounds_[i]);
+            });
+            State best_state = this->state_;
+            for (int c = 0; c < CHARACTER_N; c++)
+            {
+                best_state.setCharacter(c, this->best_placement_[c].y_, this->best_placement_[c].x_);
+            }
+            return PlacementScore{best_state, this->best_score_.load()};
+        }
+
+        int64_t evaluatedCount() const
+        {
+            return this->evaluated_count_.load();
+        }
+    };
+
+    State exhaustiveSearch(const State& state)
+    {
+        ExhaustiveSolver solver(state);
+        return solver.solve().first;
+    }
+
+    // 최적 점수와 hillClimb의 점수를 비교한다.
+    void testExhaustiveSearch(const int game_number)
+    {
+        std::mt19937 mt_for_construct(0);
+        double optimal_mean = 0;
+        double hill_climb_mean = 0;
+        int64_t evaluated_count = 0;
+        for (int i = 0; i < game_number; ++i)
+        {
+            auto state = State(mt_for_construct());
+            ExhaustiveSolver solver(state);
+            const auto [best_state, best_score] = solver.solve();
+            assert(best_state.getScore() == best_score);
+            optimal_mean += best_score;
+            evaluated_count += solver.evaluatedCount();
+            hill_climb_mean += hillClimb(state, 10000).getScore();
+        }
+        std::cout << "Optimal score:\t" << optimal_mean / game_number << "\n";
+        std::cout << "hillClimb score:\t" << hill_climb_mean / game_number << "\n";
+        std::cout << "Evaluated placements:\t" << (double)evaluated_count / game_number << "\n";
+    }
+
+    // hillClimb를 stop_token으로 언제든 멈출 수 있게 한 것. 점수가 오를 때마다 배치를 알린다.
+    // 다른 탐색과 동시에 돌 수 있으므로 전역 mt_for_action 대신 이 탐색만의 mt를 쓴다.
+    void hillClimbAsync(const State& state, int number, std::mt19937& mt, const std::stop_token& stop_token,
+                        AsyncSearch::SearchTask<PlacementScore>& task)
+    {
+        State now_state = state;
+        now_state.init(mt);
+        ScoreType best_score = now_state.getScore();
+        task.publish(PlacementScore{now_state, best_score});
+        for (int i = 0; i < number; ++i)
+        {
+            if (stop_token.stop_requested())
+            {
+                return;
+            }
+            auto next_state = now_state;
+            next_state.transition(mt);
+            auto next_score = next_state.getScore();
+            if (next_score > best_score)
+            {
+                best_score = next_score;
+                now_state = next_state;
+                task.publish(PlacementScore{now_state, best_score});
+            }
+        }
+    }
+
+    // 난수 생성기는 seed로 만들어 탐색 스레드가 가진다.
+    void startHillClimb(AsyncSearch::SearchTask<PlacementScore>& task, const State& state, int number,
+                        const uint32_t seed)
+    {
+        task.start([state, number, mt = std::mt19937(seed)](const std::stop_token& stop_token, auto& task) mutable
+        {
+            hillClimbAsync(state, number, mt, stop_token, task);
+        });
+    }
+
     void playGame(const StringAIPair& ai, const int seed)
     {
         auto state = State(seed);
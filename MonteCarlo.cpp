@@ -0,0 +1,547 @@
+//
+// Created by eu on 2026-10-19.
+//
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <bit>
+#include <random>
+#include <iostream>
+#include <vector>
+#include <sstream>
+#include <chrono>
+
+namespace MonteCarlo {
+    using ScoreType = int64_t;
+    constexpr const ScoreType INF = 1000000000LL;
+
+    struct Coord {
+        int y_;
+        int x_;
+
+        Coord(const int y = 0, const int x = 0): y_(y), x_(x) {
+        }
+    };
+
+    constexpr const int H{30};
+    constexpr const int W{30};
+    constexpr int END_TURN{100};
+
+    class TimeKeeper {
+    private:
+        std::chrono::time_point<std::chrono::high_resolution_clock> start_time_;
+        int64_t time_threshold_;
+
+    public:
+        // 시간 제한을 밀리초 단위로 지정해서 인스턴스르 생성
+        TimeKeeper(const int64_t &time_threshold): start_time_(std::chrono::high_resolution_clock::now()),
+                                                   time_threshold_(time_threshold) {
+        }
+
+        bool isTimeOver() const {
+            using std::chrono::duration_cast;
+            using std::chrono::milliseconds;
+            auto diff = std::chrono::high_resolution_clock::now() - this->start_time_;
+            return duration_cast<milliseconds>(diff).count() >= time_threshold_;
+        }
+
+        double elapsedSeconds() const {
+            std::chrono::duration<double> diff = std::chrono::high_resolution_clock::now() - this->start_time_;
+            return diff.count();
+        }
+    };
+
+    class State {
+    private:
+        int points_[H][W] = {};
+        int turn_{0};
+
+        static constexpr const int dx[4] = {1, -1, 0, 0};
+        static constexpr const int dy[4] = {0, 0, 1, -1};
+
+    public:
+        Coord character_ = Coord(0, 0);
+        int game_score_ = 0;
+
+        State() = default;
+
+        State(const int seed) {
+            auto mt_for_construct = std::mt19937(seed);
+            this->character_.y_ = mt_for_construct() % H;
+            this->character_.x_ = mt_for_construct() % W;
+
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    if (y == character_.y_ && x == character_.x_) {
+                        continue;
+                    }
+                    this->points_[y][x] = mt_for_construct() % 10;
+                }
+            }
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        int turn() const {
+            return this->turn_;
+        }
+
+        int point(const int y, const int x) const {
+            return this->points_[y][x];
+        }
+
+        void advance(const int action) {
+            this->character_.x_ += dx[action];
+            this->character_.y_ += dy[action];
+            auto &point = this->points_[this->character_.y_][this->character_.x_];
+            if (point > 0) {
+                this->game_score_ += point;
+                point = 0;
+            }
+            this->turn_++;
+        }
+
+        // 현재 상황에서 플레이어가 가능한 행동을 모두 획득한다.
+        std::vector<int> legalActions() const {
+            std::vector<int> actions;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions.emplace_back(action);
+                }
+            }
+            return actions;
+        }
+
+        // 현재 게임 상황을 문자열로 만든다.
+        std::string toString() const {
+            std::stringstream ss;
+            ss << "turn:\t" << this->turn_ << "\n";
+            ss << "score:\t" << this->game_score_ << "\n";
+            for (int h = 0; h < H; h++) {
+                for (int w = 0; w < W; w++) {
+                    if (this->character_.y_ == h && this->character_.x_ == w) {
+                        ss << '@';
+                    } else if (this->points_[h][w] > 0) {
+                        ss << points_[h][w];
+                    } else {
+                        ss << ".";
+                    }
+                }
+                ss << "\n";
+            }
+            return ss.str();
+        }
+    };
+
+    // 플레이아웃용 난수. mt19937보다 상태가 작고 빠르다.
+    class Xorshift {
+    private:
+        uint64_t x_;
+
+    public:
+        explicit Xorshift(const uint64_t seed): x_(seed * 0x9E3779B97F4A7C15ULL + 1) {
+        }
+
+        uint32_t operator()() {
+            this->x_ ^= this->x_ << 13;
+            this->x_ ^= this->x_ >> 7;
+            this->x_ ^= this->x_ << 17;
+            return static_cast<uint32_t>(this->x_ >> 32);
+        }
+    };
+
+    // 플레이아웃 전용의 작은 게임판. State를 복사하지 않고 이 위에서 게임을 끝까지 진행한다.
+    class PlayoutBoard {
+    private:
+        static constexpr const int delta[4] = {1, -1, W, -W};
+
+    public:
+        uint8_t points_[H * W];
+        int position_{0};
+        int turn_{0};
+        int game_score_{0};
+
+        void load(const State &state) {
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    this->points_[y * W + x] = static_cast<uint8_t>(state.point(y, x));
+                }
+            }
+            this->position_ = state.character_.y_ * W + state.character_.x_;
+            this->turn_ = state.turn();
+            this->game_score_ = state.game_score_;
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        // 가능한 행동을 비트로 나타낸다. (vector를 만들지 않는다)
+        int legalActionMask() const {
+            const int y = this->position_ / W;
+            const int x = this->position_ % W;
+            return (x < W - 1) | ((x > 0) << 1) | ((y < H - 1) << 2) | ((y > 0) << 3);
+        }
+
+        int nextPoint(const int action) const {
+            return this->points_[this->position_ + delta[action]];
+        }
+
+        void advance(const int action) {
+            this->position_ += delta[action];
+            this->game_score_ += this->points_[this->position_];
+            this->points_[this->position_] = 0;
+            this->turn_++;
+        }
+    };
+
+    enum class PlayoutPolicy {
+        Random,
+        // 대부분은 가장 점수가 높은 이웃으로 이동하고 가끔 무작위로 이동한다.
+        Greedy,
+    };
+
+    int randomActionFromMask(const int mask, Xorshift &rng) {
+        int k = rng() % std::popcount(static_cast<unsigned>(mask));
+        int rest = mask;
+        for (; k > 0; k--) { rest &= rest - 1; }
+        return std::countr_zero(static_cast<unsigned>(rest));
+    }
+
+    // board를 게임 끝까지 진행하고 최종 점수를 반환한다.
+    int playout(PlayoutBoard &board, const PlayoutPolicy policy, Xorshift &rng) {
+        while (!board.isDone()) {
+            const int mask = board.legalActionMask();
+            int action;
+            if (policy == PlayoutPolicy::Greedy && (rng() & 7) != 0) {
+                action = -1;
+                int best_point = -1;
+                for (int rest = mask; rest != 0; rest &= rest - 1) {
+                    const int candidate = std::countr_zero(static_cast<unsigned>(rest));
+                    const int point = board.nextPoint(candidate);
+                    if (point > best_point) {
+                        best_point = point;
+                        action = candidate;
+                    }
+                }
+            } else {
+                action = randomActionFromMask(mask, rng);
+            }
+            board.advance(action);
+        }
+        return board.game_score_;
+    }
+
+    // 가능한 행동 비트마다 k번째 행동을 미리 계산해 둔 표
+    struct ActionTable {
+        uint8_t count_[16];
+        uint8_t action_[16][4];
+
+        constexpr ActionTable(): count_(), action_() {
+            for (int mask = 0; mask < 16; mask++) {
+                int count = 0;
+                for (int action = 0; action < 4; action++) {
+                    if (mask >> action & 1) {
+                        this->action_[mask][count++] = static_cast<uint8_t>(action);
+                    }
+                }
+                this->count_[mask] = static_cast<uint8_t>(count);
+            }
+        }
+    };
+
+    constexpr const ActionTable ACTION_TABLE{};
+
+    constexpr const int PLAYOUT_LANE_N{8};
+
+    // PLAYOUT_LANE_N개의 플레이아웃을 레인별로 한 턴씩 함께 진행한다.
+    // 레인마다 게임판과 난수를 따로 가지므로 한 레인의 이동을 기다리지 않고 다른 레인을 계산할 수 있다.
+    class PlayoutBatch {
+    private:
+        static constexpr const int delta[4] = {1, -1, W, -W};
+
+        uint8_t points_[PLAYOUT_LANE_N][H * W];
+        int32_t positions_[PLAYOUT_LANE_N];
+        int32_t scores_[PLAYOUT_LANE_N];
+        uint64_t rngs_[PLAYOUT_LANE_N];
+        int turn_{0};
+
+    public:
+        // 레인의 난수는 rng에서 뽑아서 초기화한다.
+        explicit PlayoutBatch(Xorshift &rng) {
+            for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                this->rngs_[lane] = ((uint64_t) rng() << 32 | rng()) | 1;
+            }
+        }
+
+        // 레인에 board를 복사한다. 모든 레인은 같은 턴에서 시작해야 한다.
+        void load(const int lane, const PlayoutBoard &board) {
+            std::memcpy(this->points_[lane], board.points_, sizeof(board.points_));
+            this->positions_[lane] = board.position_;
+            this->scores_[lane] = board.game_score_;
+            this->turn_ = board.turn_;
+        }
+
+        int score(const int lane) const {
+            return this->scores_[lane];
+        }
+
+        // 모든 레인을 게임 끝까지 진행한다. 정책은 playout()과 같다.
+        void playout(const PlayoutPolicy policy) {
+            const bool is_greedy = policy == PlayoutPolicy::Greedy;
+            for (; this->turn_ < END_TURN; this->turn_++) {
+                for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                    uint64_t x = this->rngs_[lane];
+                    x ^= x << 13;
+                    x ^= x >> 7;
+                    x ^= x << 17;
+                    this->rngs_[lane] = x;
+                }
+                for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                    const int32_t position = this->positions_[lane];
+                    const int32_t y = position / W;
+                    const int32_t x = position - y * W;
+                    const int mask = (x < W - 1) | ((x > 0) << 1) | ((y < H - 1) << 2) | ((y > 0) << 3);
+                    const auto r = static_cast<uint32_t>(this->rngs_[lane] >> 32);
+                    int action;
+                    if (is_greedy && (r & 7) != 0) {
+                        action = -1;
+                        int best_point = -1;
+                        for (int candidate = 0; candidate < 4; candidate++) {
+                            const bool is_legal = (mask >> candidate) & 1;
+                            // 판 밖이면 자기 칸을 읽고 후보에서 뺀다.
+                            const int cell = this->points_[lane][is_legal ? position + delta[candidate] : position];
+                            const int point = is_legal ? cell : -1;
+                            if (point > best_point) {
+                                best_point = point;
+                                action = candidate;
+                            }
+                        }
+                    } else {
+                        const auto k = static_cast<uint32_t>(((uint64_t) r * ACTION_TABLE.count_[mask]) >> 32);
+                        action = ACTION_TABLE.action_[mask][k];
+                    }
+                    this->positions_[lane] = position + delta[action];
+                }
+                for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                    uint8_t &point = this->points_[lane][this->positions_[lane]];
+                    this->scores_[lane] += point;
+                    point = 0;
+                }
+            }
+        }
+    };
+
+    struct PlayoutStats {
+        int64_t playout_count_{0};
+        double seconds_{0};
+
+        double playoutsPerSecond() const {
+            return this->seconds_ > 0 ? this->playout_count_ / this->seconds_ : 0;
+        }
+    };
+
+    // 가능한 행동마다 번갈아 플레이아웃을 실행해서 평균 점수가 가장 높은 행동을 고른다.
+    // 플레이아웃은 PLAYOUT_LANE_N개씩 PlayoutBatch로 함께 진행한다.
+    int primitiveMonteCarloAction(const State &state, const int64_t time_threshold, const PlayoutPolicy policy,
+                                  Xorshift &rng, PlayoutStats &stats) {
+        auto time_keeper = TimeKeeper(time_threshold);
+        PlayoutBoard root_board;
+        PlayoutBoard board;
+        PlayoutBatch batch(rng);
+        root_board.load(state);
+
+        int actions[4];
+        int action_count = 0;
+        for (int rest = root_board.legalActionMask(); rest != 0; rest &= rest - 1) {
+            actions[action_count++] = std::countr_zero(static_cast<unsigned>(rest));
+        }
+        int64_t total_scores[4] = {};
+        int64_t counts[4] = {};
+
+        for (int64_t cnt = 0;; cnt += PLAYOUT_LANE_N) {
+            if ((cnt & 15) == 0 && time_keeper.isTimeOver()) { break; }
+            for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                std::memcpy(&board, &root_board, sizeof(PlayoutBoard));
+                board.advance(actions[(cnt + lane) % action_count]);
+                batch.load(lane, board);
+            }
+            batch.playout(policy);
+            for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                const int i = (cnt + lane) % action_count;
+                total_scores[i] += batch.score(lane);
+                counts[i]++;
+            }
+            stats.playout_count_ += PLAYOUT_LANE_N;
+        }
+        stats.seconds_ += time_keeper.elapsedSeconds();
+
+        int best_action = actions[0];
+        double best_mean = -INF;
+        for (int i = 0; i < action_count; i++) {
+            if (counts[i] == 0) { continue; }
+            double mean = total_scores[i] / (double) counts[i];
+            if (mean > best_mean) {
+                best_mean = mean;
+                best_action = actions[i];
+            }
+        }
+        return best_action;
+    }
+
+    constexpr const double C{1.0};
+    constexpr const int EXPAND_THRESHOLD{10};
+
+    // UCT 탐색. 노드는 하나의 연속된 풀에 저장하고 형제는 연속된 위치에 둔다.
+    class MonteCarloTreeSearch {
+    private:
+        struct Node {
+            int parent_;
+            int first_child_;
+            int8_t child_count_;
+            int8_t action_;
+            int visit_count_;
+            double total_value_;
+        };
+
+        std::vector<Node> nodes_;
+        size_t node_limit_;
+        Xorshift rng_;
+        PlayoutBoard root_board_;
+        PlayoutBoard board_;
+        PlayoutBatch batch_;
+
+        int addNode(const int parent, const int action) {
+            this->nodes_.push_back(Node{parent, -1, 0, static_cast<int8_t>(action), 0, 0});
+            return (int) this->nodes_.size() - 1;
+        }
+
+        void expand(const int node_id) {
+            const int first_child = (int) this->nodes_.size();
+            int count = 0;
+            for (int rest = this->board_.legalActionMask(); rest != 0; rest &= rest - 1) {
+                this->addNode(node_id, std::countr_zero(static_cast<unsigned>(rest)));
+                count++;
+            }
+            this->nodes_[node_id].first_child_ = first_child;
+            this->nodes_[node_id].child_count_ = static_cast<int8_t>(count);
+        }
+
+        int selectChild(const int node_id) const {
+            const auto &node = this->nodes_[node_id];
+            const double log_total = std::log((double) node.visit_count_);
+            int best_child = node.first_child_;
+            double best_ucb = -INF;
+            for (int child = node.first_child_; child < node.first_child_ + node.child_count_; child++) {
+                const auto &child_node = this->nodes_[child];
+                if (child_node.visit_count_ == 0) { return child; }
+                double ucb = child_node.total_value_ / child_node.visit_count_ +
+                             C * std::sqrt(2.0 * log_total / child_node.visit_count_);
+                if (ucb > best_ucb) {
+                    best_ucb = ucb;
+                    best_child = child;
+                }
+            }
+            return best_child;
+        }
+
+    public:
+        explicit MonteCarloTreeSearch(const size_t node_limit = 1 << 20, const uint64_t seed = 0)
+            : node_limit_(node_limit), rng_(seed), batch_(rng_) {
+            this->nodes_.reserve(node_limit);
+        }
+
+        int search(const State &state, const int64_t time_threshold, const PlayoutPolicy policy,
+                   PlayoutStats &stats) {
+            auto time_keeper = TimeKeeper(time_threshold);
+            // 풀은 비우기만 하고 해제하지 않는다.
+            this->nodes_.clear();
+            this->root_board_.load(state);
+            this->addNode(-1, -1);
+            this->board_ = this->root_board_;
+            this->expand(0);
+
+            // 남은 턴에 얻을 수 있는 최대 점수로 나눠 보상을 0~1로 맞춘다.
+            const double value_scale = 1.0 / (9.0 * (END_TURN - state.turn()));
+            for (int64_t cnt = 0;; cnt += PLAYOUT_LANE_N) {
+                if ((cnt & 15) == 0 && time_keeper.isTimeOver()) { break; }
+                std::memcpy(&this->board_, &this->root_board_, sizeof(PlayoutBoard));
+
+                int node_id = 0;
+                while (this->nodes_[node_id].child_count_ > 0) {
+                    node_id = this->selectChild(node_id);
+                    this->board_.advance(this->nodes_[node_id].action_);
+                }
+                if (!this->board_.isDone() && this->nodes_[node_id].visit_count_ >= EXPAND_THRESHOLD &&
+                    this->nodes_.size() + 4 <= this->node_limit_) {
+                    this->expand(node_id);
+                    node_id = this->selectChild(node_id);
+                    this->board_.advance(this->nodes_[node_id].action_);
+                }
+
+                // 고른 잎에서 PLAYOUT_LANE_N번 함께 플레이아웃하고 합을 한 번에 역전파한다.
+                for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                    this->batch_.load(lane, this->board_);
+                }
+                this->batch_.playout(policy);
+                double value = 0;
+                for (int lane = 0; lane < PLAYOUT_LANE_N; lane++) {
+                    value += (this->batch_.score(lane) - state.game_score_) * value_scale;
+                }
+                for (int id = node_id; id != -1; id = this->nodes_[id].parent_) {
+                    this->nodes_[id].visit_count_ += PLAYOUT_LANE_N;
+                    this->nodes_[id].total_value_ += value;
+                }
+                stats.playout_count_ += PLAYOUT_LANE_N;
+            }
+            stats.seconds_ += time_keeper.elapsedSeconds();
+
+            // 가장 많이 방문한 행동을 고른다.
+            const auto &root = this->nodes_[0];
+            int best_action = this->nodes_[root.first_child_].action_;
+            int best_visit = -1;
+            for (int child = root.first_child_; child < root.first_child_ + root.child_count_; child++) {
+                if (this->nodes_[child].visit_count_ > best_visit) {
+                    best_visit = this->nodes_[child].visit_count_;
+                    best_action = this->nodes_[child].action_;
+                }
+            }
+            return best_action;
+        }
+    };
+
+    void playGame(const int seed) {
+        auto state = State(seed);
+        MonteCarloTreeSearch mcts;
+        PlayoutStats stats;
+        std::cout << state.toString() << "\n";
+        while (!state.isDone()) {
+            state.advance(mcts.search(state, 10, PlayoutPolicy::Greedy, stats));
+            std::cout << state.toString() << "\n";
+        }
+        std::cout << "Playouts/sec:\t" << stats.playoutsPerSecond() << "\n";
+    }
+
+    void testAiScore(const int game_number, const PlayoutPolicy policy) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        MonteCarloTreeSearch mcts;
+        PlayoutStats stats;
+        for (int i = 0; i < game_number; i++) {
+            auto state = State(mt_for_construct());
+            while (!state.isDone()) {
+                state.advance(mcts.search(state, 10, policy, stats));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+        std::cout << "Playouts/sec:\t" << stats.playoutsPerSecond() << "\n";
+    }
+}
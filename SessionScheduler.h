@@ -0,0 +1,343 @@
+//
+// Created by eu on 2026-10-19.
+//
+
+#ifndef GAME_SESSIONSCHEDULER_H
+#define GAME_SESSIONSCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SessionScheduler {
+    using Clock = std::chrono::steady_clock;
+
+    class Scheduler;
+
+    // 스케줄러가 실행하는 게임 하나. 마감 시각이 가장 이른 세션부터 실행한다.
+    struct Session {
+        std::coroutine_handle<> root_;
+        // 다음에 재개할 코루틴. 세션 안에서 가장 안쪽에서 양보한 코루틴이다.
+        std::coroutine_handle<> resume_;
+        Clock::time_point deadline_{Clock::time_point::max()};
+        uint64_t sequence_{0};
+        // spawn()이 반환하는 세션 번호. 실패한 세션을 알릴 때 쓴다.
+        uint64_t id_{0};
+        Scheduler *scheduler_{nullptr};
+    };
+
+    namespace detail {
+        struct PromiseBase {
+            std::coroutine_handle<> continuation_{std::noop_coroutine()};
+            std::exception_ptr exception_;
+            // 이 코루틴이 속한 세션. co_await할 때 부모에서 자식으로 전해진다.
+            // (코루틴은 재개될 때마다 다른 스레드에서 돌 수 있으므로 thread_local로 들고 다니지 않는다)
+            Session *session_{nullptr};
+
+            struct FinalAwaiter {
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                // 끝나면 기다리던 코루틴으로 바로 넘어간다.
+                template<typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                    return handle.promise().continuation_;
+                }
+
+                void await_resume() const noexcept {
+                }
+            };
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            void unhandled_exception() {
+                this->exception_ = std::current_exception();
+            }
+
+            void rethrowIfFailed() const {
+                if (this->exception_) { std::rethrow_exception(this->exception_); }
+            }
+        };
+    }
+
+    template<typename T>
+    class Task;
+
+    template<typename T>
+    struct Promise : detail::PromiseBase {
+        std::optional<T> value_;
+
+        Task<T> get_return_object();
+
+        void return_value(T value) {
+            this->value_ = std::move(value);
+        }
+
+        T result() {
+            this->rethrowIfFailed();
+            return std::move(*this->value_);
+        }
+    };
+
+    template<>
+    struct Promise<void> : detail::PromiseBase {
+        Task<void> get_return_object();
+
+        void return_void() const noexcept {
+        }
+
+        void result() const {
+            this->rethrowIfFailed();
+        }
+    };
+
+    // co_await로 기다릴 수 있는 탐색 코루틴. 처음 co_await될 때 시작한다.
+    template<typename T>
+    class Task {
+    public:
+        using promise_type = Promise<T>;
+        using Handle = std::coroutine_handle<promise_type>;
+
+    private:
+        Handle handle_;
+
+    public:
+        explicit Task(const Handle handle): handle_(handle) {
+        }
+
+        Task(Task &&other) noexcept: handle_(std::exchange(other.handle_, nullptr)) {
+        }
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        ~Task() {
+            if (this->handle_) { this->handle_.destroy(); }
+        }
+
+        // 코루틴의 소유권을 넘긴다. (스케줄러가 세션으로 가져갈 때 사용)
+        Handle release() {
+            return std::exchange(this->handle_, nullptr);
+        }
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template<typename AwaitingPromise>
+        std::coroutine_handle<> await_suspend(const std::coroutine_handle<AwaitingPromise> awaiting) noexcept {
+            this->handle_.promise().continuation_ = awaiting;
+            this->handle_.promise().session_ = awaiting.promise().session_;
+            return this->handle_;
+        }
+
+        T await_resume() {
+            return this->handle_.promise().result();
+        }
+    };
+
+    template<typename T>
+    Task<T> Promise<T>::get_return_object() {
+        return Task<T>(Task<T>::Handle::from_promise(*this));
+    }
+
+    inline Task<void> Promise<void>::get_return_object() {
+        return Task<void>(Task<void>::Handle::from_promise(*this));
+    }
+
+    // 스레드 몇 개로 많은 세션을 번갈아 실행한다.
+    // 세션은 탐색의 층/반복 경계에서 yield()로 양보하고, 스케줄러는 마감 시각이 가장 이른 세션을 재개한다. (EDF)
+    class Scheduler {
+    private:
+        struct LaterDeadline {
+            bool operator()(const Session *a, const Session *b) const {
+                if (a->deadline_ != b->deadline_) { return a->deadline_ > b->deadline_; }
+                return a->sequence_ > b->sequence_;
+            }
+        };
+
+        std::mutex mutex_;
+        std::condition_variable ready_cv_;
+        std::condition_variable done_cv_;
+        std::priority_queue<Session *, std::vector<Session *>, LaterDeadline> ready_;
+        // ready_에서 가장 이른 마감 시각. 양보할 필요가 있는지 잠금 없이 확인하는 데 쓴다.
+        std::atomic<Clock::rep> earliest_ready_{std::numeric_limits<Clock::rep>::max()};
+        uint64_t sequence_{0};
+        uint64_t next_id_{0};
+        int64_t live_count_{0};
+        // 예외로 끝난 세션의 번호와 예외. 한 세션이 실패해도 다른 세션은 계속 실행한다.
+        std::vector<std::pair<uint64_t, std::exception_ptr>> failures_;
+        bool is_stopped_{false};
+        std::vector<std::jthread> threads_;
+
+        // mutex_를 잡은 상태에서 호출한다.
+        void pushReady(Session *session) {
+            session->sequence_ = this->sequence_++;
+            this->ready_.push(session);
+            this->earliest_ready_.store(this->ready_.top()->deadline_.time_since_epoch().count(),
+                                        std::memory_order_relaxed);
+        }
+
+        void workerLoop() {
+            while (true) {
+                Session *session;
+                {
+                    std::unique_lock<std::mutex> lock(this->mutex_);
+                    this->ready_cv_.wait(lock, [this] { return this->is_stopped_ || !this->ready_.empty(); });
+                    if (this->is_stopped_) { return; }
+                    session = this->ready_.top();
+                    this->ready_.pop();
+                    this->earliest_ready_.store(this->ready_.empty()
+                                                    ? std::numeric_limits<Clock::rep>::max()
+                                                    : this->ready_.top()->deadline_.time_since_epoch().count(),
+                                                std::memory_order_relaxed);
+                }
+
+                session->resume_.resume();
+
+                if (session->root_.done()) {
+                    auto root = Task<void>::Handle::from_address(session->root_.address());
+                    auto exception = root.promise().exception_;
+                    const uint64_t id = session->id_;
+                    root.destroy();
+                    delete session;
+                    std::lock_guard<std::mutex> lock(this->mutex_);
+                    if (exception) { this->failures_.emplace_back(id, std::move(exception)); }
+                    if (--this->live_count_ == 0) { this->done_cv_.notify_all(); }
+                } else {
+                    std::lock_guard<std::mutex> lock(this->mutex_);
+                    this->pushReady(session);
+                    this->ready_cv_.notify_one();
+                }
+            }
+        }
+
+    public:
+        explicit Scheduler(const int thread_n = (int) std::max(1u, std::thread::hardware_concurrency())) {
+            for (int i = 0; i < thread_n; i++) {
+                this->threads_.emplace_back([this] { this->workerLoop(); });
+            }
+        }
+
+        Scheduler(const Scheduler &) = delete;
+        Scheduler &operator=(const Scheduler &) = delete;
+
+        // 실행 중인 조각이 끝나면 멈춘다. 끝나지 않은 세션은 버린다.
+        ~Scheduler() {
+            {
+                std::lock_guard<std::mutex> lock(this->mutex_);
+                this->is_stopped_ = true;
+            }
+            this->ready_cv_.notify_all();
+            this->threads_.clear();
+            while (!this->ready_.empty()) {
+                auto *session = this->ready_.top();
+                this->ready_.pop();
+                session->root_.destroy();
+                delete session;
+            }
+        }
+
+        // 세션을 추가하고 세션 번호를 반환한다. 세션 안에서 setDeadline()으로 마감 시각을 바꿀 수 있다.
+        uint64_t spawn(Task<void> task, const Clock::time_point deadline = Clock::time_point::max()) {
+            auto *session = new Session();
+            auto root = task.release();
+            root.promise().session_ = session;
+            session->root_ = root;
+            session->resume_ = session->root_;
+            session->deadline_ = deadline;
+            session->scheduler_ = this;
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            session->id_ = this->next_id_++;
+            this->live_count_++;
+            this->pushReady(session);
+            this->ready_cv_.notify_one();
+            return session->id_;
+        }
+
+        // 모든 세션이 끝날 때까지 기다린다.
+        void waitAll() {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->done_cv_.wait(lock, [this] { return this->live_count_ == 0; });
+        }
+
+        // 지금까지 예외로 끝난 세션의 번호와 예외를 가져가고 목록을 비운다.
+        std::vector<std::pair<uint64_t, std::exception_ptr>> takeFailures() {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            return std::exchange(this->failures_, {});
+        }
+
+        // 마감 시각이 deadline 이전이거나 같은 세션이 기다리고 있는지
+        bool hasReadyBefore(const Clock::time_point deadline) const {
+            return this->earliest_ready_.load(std::memory_order_relaxed) <= deadline.time_since_epoch().count();
+        }
+    };
+
+    // co_await yield()로 양보한다. 더 급한 세션이 기다리고 있지 않으면 멈추지 않고 계속 실행한다.
+    // 스케줄러 밖에서 실행 중이면 아무것도 하지 않는다.
+    struct YieldAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        // false를 반환하면 멈추지 않고 바로 이어서 실행한다.
+        template<typename Promise>
+        bool await_suspend(const std::coroutine_handle<Promise> handle) const noexcept {
+            auto *session = handle.promise().session_;
+            if (session == nullptr || !session->scheduler_->hasReadyBefore(session->deadline_)) { return false; }
+            session->resume_ = handle;
+            return true;
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    inline YieldAwaiter yield() {
+        return {};
+    }
+
+    // co_await setDeadline(time_threshold)로 지금 세션의 마감 시각을 지금부터 time_threshold 밀리초 뒤로 정한다.
+    // 보통 한 수를 탐색하기 직전에 호출한다. 멈추지는 않는다.
+    struct DeadlineAwaiter {
+        int64_t time_threshold_;
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template<typename Promise>
+        bool await_suspend(const std::coroutine_handle<Promise> handle) const noexcept {
+            if (auto *session = handle.promise().session_; session != nullptr) {
+                session->deadline_ = Clock::now() + std::chrono::milliseconds(this->time_threshold_);
+            }
+            return false;
+        }
+
+        void await_resume() const noexcept {
+        }
+    };
+
+    inline DeadlineAwaiter setDeadline(const int64_t time_threshold) {
+        return DeadlineAwaiter{time_threshold};
+    }
+}
+
+#endif //GAME_SESSIONSCHEDULER_H
@@ -5,6 +5,9 @@
 #include <iostream>
 #include <sstream>
 #include <chrono>
+#include <cmath>
+#include "AsyncSearch.h"
+#include "SessionScheduler.h"
 
 namespace SimulatedAnnealing
 {
@@ -173,20 +176,31 @@ namespace SimulatedAnnealing
             ++this->turn_;
         }
 
-        void init()
+        // 여러 스레드에서 동시에 탐색할 때는 탐색마다 따로 가진 mt를 넘긴다.
+        void init(std::mt19937& mt)
         {
             for (auto& character : this->characters_)
             {
-                character.y_ = mt_for_action() % H;
-                character.x_ = mt_for_action() % W;
+                character.y_ = mt() % H;
+                character.x_ = mt() % W;
             }
         }
 
+        void init()
+        {
+            this->init(mt_for_action);
+        }
+
+        void transition(std::mt19937& mt)
+        {
+            auto& character = this->characters_[mt() % CHARACTER_N];
+            character.y_ = mt() % H;
+            character.x_ = mt() % W;
+        }
+
         void transition()
         {
-            auto& character = this->characters_[mt_for_action() % CHARACTER_N];
-            character.y_ = mt_for_action() % H;
-            character.x_ = mt_for_action() % W;
+            this->transition(mt_for_action);
         }
     };
 
@@ -225,38 +239,126 @@ namespace SimulatedAnnealing
         return now_state;
     }
 
+    // SimulatedAnnealing, SimulatedAnnealingAsync, SimulatedAnnealingCoroutine이 함께 쓰는 반복.
+    // 온도는 반복 횟수에 비례해 start_temp에서 end_temp로 내려간다.
+    class Annealer
+    {
+    private:
+        int number_;
+        double start_temp_;
+        double end_temp_;
+
+    public:
+        State now_state_;
+        ScoreType now_score_;
+        State best_state_;
+        ScoreType best_score_;
+
+        Annealer(const State& state, const int number, const double start_temp, const double end_temp,
+                 std::mt19937& mt)
+            : number_(number), start_temp_(start_temp), end_temp_(end_temp), now_state_(state), best_state_(state)
+        {
+            this->now_state_.init(mt);
+            this->now_score_ = this->now_state_.getScore();
+            this->best_state_ = this->now_state_;
+            this->best_score_ = this->now_score_;
+        }
+
+        // i번째 반복을 실행한다. 최고 점수가 올랐으면 true를 반환한다.
+        bool step(const int i, std::mt19937& mt)
+        {
+            auto next_state = this->now_state_;
+            next_state.transition(mt);
+            auto next_score = next_state.getScore();
+            double temp = this->start_temp_ + (this->end_temp_ - this->start_temp_) * (i / (double)this->number_);
+            double probability = exp((next_score - this->now_score_) / temp);
+
+            bool is_force_next = probability > (mt() % INF) / (double)INF;
+            if (next_score > this->now_score_ || is_force_next)
+            {
+                this->now_score_ = next_score;
+                this->now_state_ = next_state;
+            }
+            if (next_score > this->best_score_)
+            {
+                this->best_score_ = next_score;
+                this->best_state_ = next_state;
+                return true;
+            }
+            return false;
+        }
+    };
+
     State SimulatedAnnealing(const State& state, int number,
                              double start_temp, double end_temp)
     {
-        State now_state = state;
-        now_state.init();
-        ScoreType best_score = now_state.getScore();
-        ScoreType now_score = best_score;
-        auto best_state = now_state;
-
+        Annealer annealer(state, number, start_temp, end_temp, mt_for_action);
         for (int i = 0; i < number; ++i)
         {
-            auto next_state = now_state;
-            next_state.transition();
-            auto next_score = next_state.getScore();
-            double temp = start_temp + (end_temp - start_temp) / (i / number);
-            double probability = exp((next_score - now_score) / temp);
+            annealer.step(i, mt_for_action);
+        }
+        return annealer.best_state_;
+    }
+
 
-            bool is_force_next = probability > (mt_for_action() % INF) / (double)INF;
-            if (next_score > now_score || is_force_next)
+    // 배치와 그 점수
+    using PlacementScore = std::pair<State, ScoreType>;
+
+    // SimulatedAnnealing을 stop_token으로 언제든 멈출 수 있게 한 것. 최고 점수가 오를 때마다 배치를 알린다.
+    // 다른 탐색과 동시에 돌 수 있으므로 전역 mt_for_action 대신 이 탐색만의 mt를 쓴다.
+    void SimulatedAnnealingAsync(const State& state, int number, double start_temp, double end_temp,
+                                 std::mt19937& mt, const std::stop_token& stop_token,
+                                 AsyncSearch::SearchTask<PlacementScore>& task)
+    {
+        Annealer annealer(state, number, start_temp, end_temp, mt);
+        task.publish(PlacementScore{annealer.best_state_, annealer.best_score_});
+
+        for (int i = 0; i < number; ++i)
+        {
+            if (stop_token.stop_requested())
             {
-                now_score = next_score;
-                now_state = next_state;
+                return;
             }
-            if (next_score < best_score)
+            if (annealer.step(i, mt))
             {
-                best_score = next_score;
-                best_state = next_state;
+                task.publish(PlacementScore{annealer.best_state_, annealer.best_score_});
             }
         }
-        return best_state;
     }
 
+    // 난수 생성기는 seed로 만들어 탐색 스레드가 가진다.
+    void startSimulatedAnnealing(AsyncSearch::SearchTask<PlacementScore>& task, const State& state, int number,
+                                 double start_temp, double end_temp, const uint32_t seed)
+    {
+        task.start([state, number, start_temp, end_temp, mt = std::mt19937(seed)](
+            const std::stop_token& stop_token, auto& task) mutable
+            {
+                SimulatedAnnealingAsync(state, number, start_temp, end_temp, mt, stop_token, task);
+            });
+    }
+
+    // 스케줄러에 양보하는 반복 간격
+    constexpr const int ANNEALING_YIELD_INTERVAL{256};
+
+    // SimulatedAnnealing을 코루틴으로 만든 것. ANNEALING_YIELD_INTERVAL번 반복할 때마다 스케줄러에 양보한다.
+    // 세션은 여러 작업 스레드에서 동시에 돌므로 난수 생성기는 seed로 만들어 코루틴 프레임에 둔다.
+    SessionScheduler::Task<State> SimulatedAnnealingCoroutine(const State state, int number,
+                                                              double start_temp, double end_temp,
+                                                              const uint32_t seed)
+    {
+        std::mt19937 mt_for_session(seed);
+        Annealer annealer(state, number, start_temp, end_temp, mt_for_session);
+
+        for (int i = 0; i < number; ++i)
+        {
+            if (i % ANNEALING_YIELD_INTERVAL == 0)
+            {
+                co_await SessionScheduler::yield();
+            }
+            annealer.step(i, mt_for_session);
+        }
+        co_return annealer.best_state_;
+    }
 
     void testAiScore(const StringAIPair& ai, const int game_number)
     {
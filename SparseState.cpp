@@ -0,0 +1,241 @@
+//
+// Created by eu on 2026-10-19.
+//
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <iostream>
+#include <vector>
+#include <sstream>
+#include <queue>
+#include <chrono>
+#include <algorithm>
+
+namespace SparseState {
+    using ScoreType = int64_t;
+    constexpr const ScoreType INF = 1000000000LL;
+
+    struct Coord {
+        int y_;
+        int x_;
+
+        Coord(const int y = 0, const int x = 0): y_(y), x_(x) {
+        }
+    };
+
+    // 상태마다 게임판을 복사할 수 없을 만큼 큰 게임판
+    constexpr const int H{1000};
+    constexpr const int W{1000};
+    constexpr int END_TURN{100};
+
+    class TimeKeeper {
+    private:
+        std::chrono::time_point<std::chrono::high_resolution_clock> start_time_;
+        int64_t time_threshold_;
+
+    public:
+        // 시간 제한을 밀리초 단위로 지정해서 인스턴스르 생성
+        TimeKeeper(const int64_t &time_threshold): start_time_(std::chrono::high_resolution_clock::now()),
+                                                   time_threshold_(time_threshold) {
+        }
+
+        bool isTimeOver() const {
+            using std::chrono::duration_cast;
+            using std::chrono::milliseconds;
+            auto diff = std::chrono::high_resolution_clock::now() - this->start_time_;
+            return duration_cast<milliseconds>(diff).count() >= time_threshold_;
+        }
+    };
+
+    // 게임 시작 시점의 게임판. 한 번 만든 뒤에는 바뀌지 않으며 모든 상태가 공유한다.
+    class Board {
+    private:
+        std::vector<int8_t> points_;
+
+    public:
+        Coord start_;
+
+        explicit Board(const int seed): points_(H * W, 0) {
+            auto mt_for_construct = std::mt19937(seed);
+            this->start_.y_ = mt_for_construct() % H;
+            this->start_.x_ = mt_for_construct() % W;
+
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    if (y == start_.y_ && x == start_.x_) {
+                        continue;
+                    }
+                    this->points_[y * W + x] = (int8_t) (mt_for_construct() % 10);
+                }
+            }
+        }
+
+        int point(const int cell) const {
+            return this->points_[cell];
+        }
+    };
+
+    // 게임판은 공유하고 점수를 얻은 칸 번호만 정렬해서 가진다. 상태 하나의 크기는 진행한 턴 수에 비례한다.
+    class State {
+    private:
+        const Board *board_{nullptr};
+        std::vector<int> collected_cells_;
+        int turn_{0};
+
+        static constexpr const int dx[4] = {1, -1, 0, 0};
+        static constexpr const int dy[4] = {0, 0, 1, -1};
+
+        bool isCollected(const int cell) const {
+            return std::binary_search(this->collected_cells_.begin(), this->collected_cells_.end(), cell);
+        }
+
+    public:
+        // 탐색 트리의 루트 노드에서 처음으로 선택한 행동
+        int first_action_{-1};
+
+        friend bool operator<(const State &maze_1, const State &maze_2) {
+            return maze_1.evaluated_score_ < maze_2.evaluated_score_;
+        }
+
+    public:
+        Coord character_ = Coord(0, 0);
+        int game_score_ = 0;
+
+        State() = default;
+
+        // board는 이 상태와 이 상태에서 만든 모든 상태보다 오래 살아 있어야 한다.
+        explicit State(const Board &board): board_(&board), character_(board.start_) {
+            this->collected_cells_.reserve(END_TURN);
+        }
+
+        bool isDone() const {
+            return this->turn_ == END_TURN;
+        }
+
+        int point(const int y, const int x) const {
+            const int cell = y * W + x;
+            return this->isCollected(cell) ? 0 : this->board_->point(cell);
+        }
+
+        void advance(const int action) {
+            this->character_.x_ += dx[action];
+            this->character_.y_ += dy[action];
+            const int cell = this->character_.y_ * W + this->character_.x_;
+            const int point = this->board_->point(cell);
+            if (point > 0) {
+                auto it = std::lower_bound(this->collected_cells_.begin(), this->collected_cells_.end(), cell);
+                if (it == this->collected_cells_.end() || *it != cell) {
+                    this->game_score_ += point;
+                    this->collected_cells_.insert(it, cell);
+                }
+            }
+            this->turn_++;
+        }
+
+        // 현재 상황에서 플레이어가 가능한 행동을 모두 획득한다.
+        std::vector<int> legalActions() const {
+            std::vector<int> actions;
+            for (int action = 0; action < 4; action++) {
+                int ty = this->character_.y_ + dy[action];
+                int tx = this->character_.x_ + dx[action];
+                if (ty >= 0 && ty < H && tx >= 0 && tx < W) {
+                    actions.emplace_back(action);
+                }
+            }
+            return actions;
+        }
+
+        // 현재 게임 상황을 문자열로 만든다. 게임판이 크므로 캐릭터 주변 radius칸만 출력한다.
+        std::string toString(const int radius = 5) const {
+            std::stringstream ss;
+            ss << "turn:\t" << this->turn_ << "\n";
+            ss << "score:\t" << this->game_score_ << "\n";
+            for (int h = std::max(0, this->character_.y_ - radius);
+                 h <= std::min(H - 1, this->character_.y_ + radius); h++) {
+                for (int w = std::max(0, this->character_.x_ - radius);
+                     w <= std::min(W - 1, this->character_.x_ + radius); w++) {
+                    if (this->character_.y_ == h && this->character_.x_ == w) {
+                        ss << '@';
+                    } else if (this->point(h, w) > 0) {
+                        ss << this->point(h, w);
+                    } else {
+                        ss << ".";
+                    }
+                }
+                ss << "\n";
+            }
+            return ss.str();
+        }
+
+    public:
+        // 탐색을 통해 확인한 점수
+        ScoreType evaluated_score_ = 0;
+        // 탐색용으로 게임판을 평가
+        void evaluateScore() {
+            // 간단히 우선 기록 점수를 그대로 게임판의 평가로 사용
+            this->evaluated_score_ = this->game_score_;
+        }
+    };
+
+    int beamSearchActionWithTimeThreshold(const State &state, const int beam_width, const int64_t time_threshold) {
+        auto time_keeper = TimeKeeper(time_threshold);
+
+        std::priority_queue<State> now_beam;
+        State best_state;
+
+        now_beam.push(state);
+        for (int t = 0; ; t++) {
+            std::priority_queue<State> next_beam;
+            for (int i = 0; i < beam_width; ++i) {
+                if (time_keeper.isTimeOver()) {
+                    return best_state.first_action_;
+                }
+                if (now_beam.empty()) { break; }
+
+                State now_state = now_beam.top();
+                now_beam.pop();
+                auto legal_actions = now_state.legalActions();
+                for (const auto &action: legal_actions) {
+                    State next_state = now_state;
+                    next_state.advance(action);
+                    next_state.evaluateScore();
+                    if (t == 0)
+                        next_state.first_action_ = action;
+                    next_beam.push(next_state);
+                }
+            }
+
+            now_beam = std::move(next_beam);
+            best_state = now_beam.top();
+
+            if (best_state.isDone()) { break; }
+        }
+        return best_state.first_action_;
+    }
+
+    void playGame(const int seed) {
+        const auto board = Board(seed);
+        auto state = State(board);
+        std::cout << state.toString() << "\n";
+        while (!state.isDone()) {
+            state.advance(beamSearchActionWithTimeThreshold(state, 5, 10));
+            std::cout << state.toString() << "\n";
+        }
+    }
+
+    void testAiScore(const int game_number) {
+        std::mt19937 mt_for_construct(0);
+        double score_mean{0};
+        for (int i = 0; i < game_number; i++) {
+            const auto board = Board(mt_for_construct());
+            auto state = State(board);
+            while (!state.isDone()) {
+                state.advance(beamSearchActionWithTimeThreshold(state, 5, 10));
+            }
+            auto score = state.game_score_;
+            score_mean += score;
+        }
+        score_mean /= (double) game_number;
+        std::cout << "Score:\t" << score_mean << "\n";
+    }
+}
@@ -0,0 +1,412 @@
+//
+// Created by eu on 2026-10-19.
+//
+
+#ifndef GAME_THREADPOOL_H
+#define GAME_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ThreadPool {
+    // 풀에서 실행하는 작업. 함수 포인터와 인자만 가지므로 작업을 넣을 때 힙 할당이 없다.
+    // function_은 예외를 던지면 안 된다. (TaskGroup이 넣는 작업은 예외를 잡아서 wait()으로 넘긴다)
+    struct Task {
+        void (*function_)(void *){nullptr};
+        void *argument_{nullptr};
+    };
+
+    // 작업자마다 하나씩 가지는 Chase-Lev 덱.
+    // 주인은 bottom 쪽에서 넣고 꺼내며, 다른 작업자는 top 쪽에서 잠금 없이 훔쳐 간다.
+    class WorkStealingDeque {
+    private:
+        struct Slot {
+            std::atomic<void (*)(void *)> function_{nullptr};
+            std::atomic<void *> argument_{nullptr};
+        };
+
+        static constexpr const int64_t CAPACITY{1 << 14};
+        static constexpr const int64_t MASK{CAPACITY - 1};
+
+        alignas(64) std::atomic<int64_t> top_{0};
+        alignas(64) std::atomic<int64_t> bottom_{0};
+        alignas(64) std::unique_ptr<Slot[]> slots_{new Slot[CAPACITY]};
+
+    public:
+        // 가득 차 있으면 false를 반환한다. (호출한 쪽이 바로 실행한다)
+        bool push(const Task &task) {
+            const int64_t b = this->bottom_.load(std::memory_order_relaxed);
+            const int64_t t = this->top_.load(std::memory_order_acquire);
+            if (b - t >= CAPACITY) { return false; }
+            auto &slot = this->slots_[b & MASK];
+            slot.function_.store(task.function_, std::memory_order_relaxed);
+            slot.argument_.store(task.argument_, std::memory_order_relaxed);
+            this->bottom_.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 주인만 호출한다. 가장 최근에 넣은 작업을 꺼낸다.
+        bool pop(Task &task) {
+            const int64_t b = this->bottom_.load(std::memory_order_relaxed) - 1;
+            this->bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = this->top_.load(std::memory_order_relaxed);
+            if (t > b) {
+                this->bottom_.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            const auto &slot = this->slots_[b & MASK];
+            task.function_ = slot.function_.load(std::memory_order_relaxed);
+            task.argument_ = slot.argument_.load(std::memory_order_relaxed);
+            if (t == b) {
+                // 마지막 하나는 도둑과 경쟁한다.
+                const bool is_won = this->top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                                       std::memory_order_relaxed);
+                this->bottom_.store(b + 1, std::memory_order_relaxed);
+                return is_won;
+            }
+            return true;
+        }
+
+        // 다른 스레드가 호출한다. 가장 오래된 작업을 훔친다.
+        bool steal(Task &task) {
+            int64_t t = this->top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t b = this->bottom_.load(std::memory_order_acquire);
+            if (t >= b) { return false; }
+            const auto &slot = this->slots_[t & MASK];
+            task.function_ = slot.function_.load(std::memory_order_relaxed);
+            task.argument_ = slot.argument_.load(std::memory_order_relaxed);
+            return this->top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed);
+        }
+
+        bool isEmpty() const {
+            return this->top_.load(std::memory_order_acquire) >= this->bottom_.load(std::memory_order_acquire);
+        }
+    };
+
+    class WorkStealingPool;
+
+    namespace detail {
+        // 현재 스레드가 어느 풀의 몇 번째 작업자인지 (작업자가 아니면 nullptr / -1)
+        inline thread_local WorkStealingPool *current_pool = nullptr;
+        inline thread_local int current_worker = -1;
+        // 기다리는 동안 남의 작업을 몇 겹까지 실행하고 있는지. 스택이 끝없이 깊어지는 것을 막는다.
+        inline thread_local int help_depth = 0;
+        constexpr const int MAX_HELP_DEPTH{16};
+
+        // 이 프로세스가 쓸 수 있는 CPU 번호. 컨테이너나 cpuset으로 제한되어 있으면 그 안의 CPU만 들어 있다.
+        inline std::vector<int> allowedCpus() {
+            std::vector<int> cpus;
+#ifdef __linux__
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                    if (CPU_ISSET(cpu, &cpu_set)) { cpus.push_back(cpu); }
+                }
+            }
+#endif
+            return cpus;
+        }
+
+        inline int defaultThreadCount() {
+            const auto cpu_n = (int) allowedCpus().size();
+            return cpu_n > 0 ? cpu_n : (int) std::max(1u, std::thread::hardware_concurrency());
+        }
+    }
+
+    // 작업자마다 덱을 하나씩 두고, 할 일이 없으면 다른 작업자의 덱에서 훔쳐 오는 스레드 풀.
+    // 작업자가 아닌 스레드가 넣은 작업은 잠금이 있는 공용 큐를 거친다.
+    class WorkStealingPool {
+    private:
+        struct alignas(64) Worker {
+            WorkStealingDeque deque_;
+            uint64_t rng_{0};
+        };
+
+        std::vector<std::unique_ptr<Worker> > workers_;
+        std::vector<std::thread> threads_;
+
+        std::mutex inject_mutex_;
+        std::deque<Task> inject_queue_;
+        std::atomic<int64_t> inject_count_{0};
+
+        std::atomic<bool> is_stopped_{false};
+        std::atomic<int> sleeping_count_{0};
+        std::atomic<uint32_t> wake_epoch_{0};
+
+        static constexpr const int SPIN_N{64};
+
+        void wakeOne() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (this->sleeping_count_.load(std::memory_order_relaxed) > 0) {
+                this->wake_epoch_.fetch_add(1, std::memory_order_release);
+                this->wake_epoch_.notify_one();
+            }
+        }
+
+        bool popInjected(Task &task) {
+            if (this->inject_count_.load(std::memory_order_acquire) == 0) { return false; }
+            std::lock_guard<std::mutex> lock(this->inject_mutex_);
+            if (this->inject_queue_.empty()) { return false; }
+            task = this->inject_queue_.front();
+            this->inject_queue_.pop_front();
+            this->inject_count_.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+
+        bool hasWork() const {
+            if (this->inject_count_.load(std::memory_order_acquire) > 0) { return true; }
+            for (const auto &worker: this->workers_) {
+                if (!worker->deque_.isEmpty()) { return true; }
+            }
+            return false;
+        }
+
+        // cpu가 -1이면 고정하지 않는다.
+        void workerLoop(const int worker_id, const int cpu) {
+            detail::current_pool = this;
+            detail::current_worker = worker_id;
+#ifdef __linux__
+            if (cpu >= 0) {
+                cpu_set_t cpu_set;
+                CPU_ZERO(&cpu_set);
+                CPU_SET(cpu, &cpu_set);
+                pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+            }
+#else
+            (void) cpu;
+#endif
+            Task task;
+            int idle_count = 0;
+            while (!this->is_stopped_.load(std::memory_order_acquire)) {
+                if (this->tryGetTask(task)) {
+                    task.function_(task.argument_);
+                    idle_count = 0;
+                    continue;
+                }
+                if (++idle_count < SPIN_N) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // 잠들기 직전에 다시 확인해서 깨우기 신호를 놓치지 않는다.
+                const uint32_t epoch = this->wake_epoch_.load(std::memory_order_acquire);
+                this->sleeping_count_.fetch_add(1, std::memory_order_seq_cst);
+                if (!this->hasWork() && !this->is_stopped_.load(std::memory_order_acquire)) {
+                    this->wake_epoch_.wait(epoch, std::memory_order_acquire);
+                }
+                this->sleeping_count_.fetch_sub(1, std::memory_order_relaxed);
+                idle_count = 0;
+            }
+            detail::current_pool = nullptr;
+            detail::current_worker = -1;
+        }
+
+    public:
+        // 기본 작업자 수는 프로세스가 쓸 수 있는 CPU 수다.
+        // is_pinned이면 작업자 i를 쓸 수 있는 CPU 중 i % CPU 수번째에 고정한다.
+        // 탐색 스레드나 세션 스케줄러처럼 고정하지 않은 스레드와 CPU를 나눠 쓰게 되므로 기본으로는 고정하지 않는다.
+        explicit WorkStealingPool(const int thread_n = detail::defaultThreadCount(), const bool is_pinned = false) {
+            for (int i = 0; i < thread_n; i++) {
+                this->workers_.emplace_back(std::make_unique<Worker>());
+                this->workers_.back()->rng_ = 0x9E3779B97F4A7C15ULL * (i + 1);
+            }
+            const auto cpus = is_pinned ? detail::allowedCpus() : std::vector<int>();
+            for (int i = 0; i < thread_n; i++) {
+                const int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+                this->threads_.emplace_back([this, i, cpu] { this->workerLoop(i, cpu); });
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        ~WorkStealingPool() {
+            this->is_stopped_.store(true, std::memory_order_release);
+            this->wake_epoch_.fetch_add(1, std::memory_order_release);
+            this->wake_epoch_.notify_all();
+            for (auto &thread: this->threads_) {
+                thread.join();
+            }
+        }
+
+        int size() const {
+            return (int) this->workers_.size();
+        }
+
+        // 작업자 스레드에서 넣으면 자기 덱에, 그 밖의 스레드에서 넣으면 공용 큐에 들어간다.
+        void submit(const Task &task) {
+            if (detail::current_pool == this) {
+                if (!this->workers_[detail::current_worker]->deque_.push(task)) {
+                    // 덱이 가득 차면 그 자리에서 실행한다.
+                    task.function_(task.argument_);
+                    return;
+                }
+            } else {
+                std::lock_guard<std::mutex> lock(this->inject_mutex_);
+                this->inject_queue_.push_back(task);
+                this->inject_count_.fetch_add(1, std::memory_order_release);
+            }
+            this->wakeOne();
+        }
+
+        // 자기 덱 -> 공용 큐 -> 다른 작업자의 덱 순서로 작업을 찾는다. 어느 스레드에서도 호출할 수 있다.
+        // is_own_only가 true이면 자기 덱만 본다.
+        bool tryGetTask(Task &task, const bool is_own_only = false) {
+            const int worker_id = detail::current_pool == this ? detail::current_worker : -1;
+            if (worker_id >= 0 && this->workers_[worker_id]->deque_.pop(task)) { return true; }
+            if (is_own_only) { return false; }
+            if (this->popInjected(task)) { return true; }
+
+            const int n = (int) this->workers_.size();
+            uint64_t r;
+            if (worker_id >= 0) {
+                auto &rng = this->workers_[worker_id]->rng_;
+                rng ^= rng << 13;
+                rng ^= rng >> 7;
+                rng ^= rng << 17;
+                r = rng;
+            } else {
+                r = std::hash<std::thread::id>()(std::this_thread::get_id());
+            }
+            for (int i = 0; i < n; i++) {
+                const int victim = (int) ((r + i) % n);
+                if (victim == worker_id) { continue; }
+                if (this->workers_[victim]->deque_.steal(task)) { return true; }
+            }
+            return false;
+        }
+    };
+
+    // 모든 탐색이 함께 쓰는 풀. 처음 사용할 때 쓸 수 있는 CPU 수만큼 작업자를 만든다.
+    inline WorkStealingPool &globalPool() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    // fork-join용 작업 묶음. run()으로 넣은 작업이 모두 끝날 때까지 wait()이 (다른 작업을 도우며) 기다린다.
+    // run()에 넘긴 함수 객체는 wait()이 끝날 때까지 살아 있어야 한다.
+    // 작업이 던진 예외는 작업자 밖으로 나가지 않고, 처음 것 하나를 wait()이 다시 던진다.
+    class TaskGroup {
+    private:
+        template<typename Function>
+        struct Spawned {
+            Function *function_;
+            TaskGroup *group_;
+
+            static void invoke(void *argument) {
+                auto *spawned = static_cast<Spawned *>(argument);
+                try {
+                    (*spawned->function_)();
+                } catch (...) {
+                    spawned->group_->fail(std::current_exception());
+                }
+                spawned->group_->pending_.fetch_sub(1, std::memory_order_acq_rel);
+            }
+        };
+
+        WorkStealingPool &pool_;
+        std::atomic<int64_t> pending_{0};
+        std::atomic<bool> is_failed_{false};
+        // pending_을 줄이기 전에 기록하므로 pending_이 0이 된 뒤에는 잠금 없이 읽을 수 있다.
+        std::exception_ptr exception_;
+
+        void fail(std::exception_ptr exception) {
+            bool expected = false;
+            if (this->is_failed_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                this->exception_ = std::move(exception);
+            }
+        }
+
+        void join() {
+            Task task;
+            while (this->pending_.load(std::memory_order_acquire) > 0) {
+                const bool is_own_only = detail::help_depth >= detail::MAX_HELP_DEPTH;
+                if (this->pool_.tryGetTask(task, is_own_only)) {
+                    detail::help_depth++;
+                    task.function_(task.argument_);
+                    detail::help_depth--;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    public:
+        explicit TaskGroup(WorkStealingPool &pool = globalPool()): pool_(pool) {
+        }
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        // 소멸자에서는 예외를 던질 수 없으므로 기다리기만 한다.
+        ~TaskGroup() {
+            this->join();
+        }
+
+        // spawned는 작업이 끝날 때까지 살아 있는 저장소여야 한다. (보통 호출한 쪽의 스택)
+        template<typename Function>
+        void run(Spawned<Function> &spawned, Function &function) {
+            spawned.function_ = &function;
+            spawned.group_ = this;
+            this->pending_.fetch_add(1, std::memory_order_relaxed);
+            this->pool_.submit(Task{&Spawned<Function>::invoke, &spawned});
+        }
+
+        template<typename Function>
+        using Handle = Spawned<Function>;
+
+        void wait() {
+            this->join();
+            if (this->is_failed_.load(std::memory_order_acquire)) {
+                auto exception = std::move(this->exception_);
+                this->exception_ = nullptr;
+                this->is_failed_.store(false, std::memory_order_relaxed);
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+
+    // a와 b를 병렬로 실행하고 둘 다 끝날 때까지 기다린다. b는 훔쳐 갈 수 있게 넣고 a는 바로 실행한다.
+    // 예외는 둘 다 끝난 뒤에 호출한 쪽으로 나간다. (둘 다 던지면 a의 예외)
+    template<typename FunctionA, typename FunctionB>
+    void parallelInvoke(FunctionA &&a, FunctionB &&b, WorkStealingPool &pool = globalPool()) {
+        // a가 예외를 던져도 group의 소멸자가 b를 기다리는 동안 handle이 살아 있도록 먼저 만든다.
+        TaskGroup::Handle<std::remove_reference_t<FunctionB> > handle{};
+        TaskGroup group(pool);
+        group.run(handle, b);
+        a();
+        group.wait();
+    }
+
+    // [begin, end)의 i마다 function(i)를 실행한다. grain 이하가 될 때까지 반씩 나눠 절반을 훔쳐 갈 수 있게 한다.
+    template<typename Function>
+    void parallelFor(const int64_t begin, const int64_t end, const int64_t grain, const Function &function,
+                     WorkStealingPool &pool = globalPool()) {
+        if (end - begin <= std::max<int64_t>(1, grain)) {
+            for (int64_t i = begin; i < end; i++) {
+                function(i);
+            }
+            return;
+        }
+        const int64_t middle = begin + (end - begin) / 2;
+        parallelInvoke([&] { parallelFor(begin, middle, grain, function, pool); },
+                       [&] { parallelFor(middle, end, grain, function, pool); }, pool);
+    }
+}
+
+#endif //GAME_THREADPOOL_H